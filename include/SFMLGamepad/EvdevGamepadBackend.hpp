@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/GamepadBackend.hpp>
+
+#include <SFML/System/Time.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sf
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Backend that reads the Linux evdev devices directly
+///
+/// Devices are read through epoll: their state only changes when
+/// they send events, and all their buttons and axes are available
+/// to the mappings, including the axes that sf::Joystick does not
+/// have. Buttons and axes are numbered like SDL does, which is how
+/// the mapping databases number them.
+///
+/// Only available on Linux, when the library is built with the
+/// SFML_GAMEPAD_EVDEV option.
+///
+////////////////////////////////////////////////////////////
+class SFML_GAMEPAD_API EvdevGamepadBackend : public GamepadBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Range of an evdev axis
+    ///
+    ////////////////////////////////////////////////////////////
+    struct AxisInfo
+    {
+        unsigned int code = 0;      //!< ABS code of the axis
+        int          minimum = 0;   //!< Value of the axis at -100
+        int          maximum = 0;   //!< Value of the axis at 100
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Description of an evdev device
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DeviceInfo
+    {
+        Joystick::Identification  identification;  //!< Name, vendor and product IDs
+        unsigned int              bus = 0;          //!< Bus type, i.e. BUS_USB
+        unsigned int              version = 0;      //!< Version of the device
+        std::vector<unsigned int> buttons;          //!< KEY codes of the buttons, in button order
+        std::vector<AxisInfo>     axes;             //!< ABS axes, in axis order, without the hats
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the backend, without any device
+    ///
+    ////////////////////////////////////////////////////////////
+    EvdevGamepadBackend();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor, closes the devices
+    ///
+    ////////////////////////////////////////////////////////////
+    ~EvdevGamepadBackend() override;
+
+    EvdevGamepadBackend(const EvdevGamepadBackend&) = delete;
+    EvdevGamepadBackend& operator=(const EvdevGamepadBackend&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Attach the joysticks of a directory that are not attached yet
+    ///
+    /// Devices that have X and Y axes and joystick or gamepad
+    /// buttons are considered joysticks. Can be called again to
+    /// find the joysticks plugged since the last call.
+    ///
+    /// \param directory  Directory of the event devices
+    ///
+    /// \return Number of joysticks attached
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int scan(const std::string& directory = "/dev/input");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Attach an opened evdev device
+    ///
+    /// The description of the device is queried from it. The
+    /// backend owns the descriptor, which is closed when the
+    /// device is disconnected or cannot be attached.
+    ///
+    /// \param fd  Descriptor of the device
+    ///
+    /// \return True if the device has been attached, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool attach(int fd);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Attach a stream of evdev events with a known description
+    ///
+    /// The descriptor can be a pipe or a socket that carries
+    /// input_event records, for example a recorded evdev stream.
+    /// The device is disconnected at the end of the stream. The
+    /// backend owns the descriptor, like with attach(int).
+    ///
+    /// \param fd    Descriptor of the stream
+    /// \param info  Description of the device
+    ///
+    /// \return True if the device has been attached, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool attach(int fd, const DeviceInfo& info);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until a device sends events
+    ///
+    /// Lets an input thread sleep until there is something to read
+    /// with update(), instead of polling.
+    ///
+    /// \param timeout  Maximum time to wait
+    ///
+    /// \return True if events are waiting, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool wait(Time timeout);
+
+    unsigned int getCount() override;
+    bool update() override;
+    bool isConnected(unsigned int joystick) override;
+    Joystick::Identification getIdentification(unsigned int joystick) override;
+    bool isButtonPressed(unsigned int joystick, unsigned int button) override;
+    float getAxisPosition(unsigned int joystick, Joystick::Axis axis) override;
+    float getExtendedAxisPosition(unsigned int joystick, unsigned int axis) override;
+    bool getGuid(unsigned int joystick, Guid& guid) override;
+    bool getConnection(unsigned int joystick, unsigned int& connection) override;
+
+private:
+    struct Device;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a device in the first free slot
+    ///
+    /// \param fd    Descriptor of the device
+    /// \param info  Description of the device
+    /// \param path  Path of the device, empty if not scanned
+    ///
+    /// \return True if the device has been added, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool add(int fd, const DeviceInfo& info, const std::string& path);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the pending events of a device
+    ///
+    /// \param device  Device to read
+    ///
+    /// \return False if the device is gone, true otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool readEvents(Device& device);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Query the current state of a device
+    ///
+    /// Used when attaching a device and when the kernel dropped
+    /// events. Streams keep their state.
+    ///
+    /// \param device  Device to query
+    ///
+    ////////////////////////////////////////////////////////////
+    static void resync(Device& device);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Close a device and free its slot
+    ///
+    /// \param device  Device to close
+    ///
+    ////////////////////////////////////////////////////////////
+    void detach(Device& device);
+
+    int                 _epoll;             //!< epoll instance watching the devices
+    std::vector<Device> _devices;           //!< Devices, one per slot
+    unsigned int        _connections = 0;   //!< Number of devices attached so far
+};
+
+}
@@ -28,10 +28,17 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <SFMLGamepad/Config.hpp>
 
+#include <SFML/System/Time.hpp>
+
 namespace sf
 {
+class GamepadBackend;
+struct GamepadEvent;
 
 ////////////////////////////////////////////////////////////
 /// \brief Add mappings to sf::Joystick
@@ -76,6 +83,95 @@ public:
         Misc1           //!< Miscellaneous control #1
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Number of values in the Control enumeration, None included
+    ///
+    ////////////////////////////////////////////////////////////
+    static constexpr unsigned int ControlCount = static_cast<unsigned int>(Control::Misc1) + 1;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the mask of a set of controls
+    ///
+    /// Masks use one bit per control, the bit index being the
+    /// Control value, like the ones returned by getPressedMask().
+    /// Control::None has no bit.
+    ///
+    /// \param controls  Controls to include in the mask
+    ///
+    /// \return Mask of the controls
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename... Controls>
+    static constexpr std::uint32_t getMask(Controls... controls)
+    {
+        return (0u | ... | (controls == Control::None ? 0u : 1u << static_cast<unsigned int>(controls)));
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Positions and pressed states of all the controls of a gamepad
+    ///
+    /// Both arrays are indexed by Control. Controls that the gamepad
+    /// does not support are reported as released, at position 0.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct State
+    {
+        bool          available = false;            //!< True if the gamepad was available when captured
+        std::uint32_t pressed = 0;                  //!< Pressed states, one bit per control
+        float         positions[ControlCount]{};    //!< Positions in range [0 .. 100]
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Check if a control was pressed when captured
+        ///
+        /// \param control  Control to check
+        ///
+        /// \return True if the control was pressed, false otherwise
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isPressed(Control control) const
+        {
+            return (pressed >> static_cast<unsigned int>(control)) & 1u;
+        }
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the position of a control when captured
+        ///
+        /// \param control  Control to check
+        ///
+        /// \return Position of the control, in range [0 .. 100]
+        ///
+        ////////////////////////////////////////////////////////////
+        float getPosition(Control control) const
+        {
+            return positions[static_cast<unsigned int>(control)];
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief State of a gamepad captured by the sampling thread
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Sample
+    {
+        unsigned int gamepad = 0;   //!< Index of the gamepad
+        Time         timestamp;     //!< Time of the capture, since the sampling started
+        State        state;         //!< Captured state
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mapping of a controller, as stored in a mapping table
+    ///
+    /// Mapping tables are generated at build time by the
+    /// sfml_gamepad_embed_mapping() CMake function.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Mapping
+    {
+        std::uint32_t id;                       //!< Vendor ID in the high word, product ID in the low word
+        const char*   name;                     //!< Name of the controller
+        std::uint8_t  controls[ControlCount];   //!< Encoded control descriptions, indexed by Control
+    };
+
     ///////////////////////////////////////////////////////////
     /// \brief Load a mapping database from a file
     ///
@@ -92,6 +188,156 @@ public:
     ///////////////////////////////////////////////////////////
     static void loadMappingFromString(const std::string& db);
 
+    ///////////////////////////////////////////////////////////
+    /// \brief Load a compiled mapping database from a file
+    ///
+    /// Compiled databases are produced from text databases by the
+    /// sfml-gamepad-dbc tool. They only contain the mappings of one
+    /// platform and load without any parsing.
+    ///
+    /// \param filename  Path of the database to load
+    ///
+    /// \return True if the database has been loaded, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool loadMappingFromBinary(const std::string& filename);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Use a mapping table generated at build time
+    ///
+    /// The table is used in place: it is neither parsed nor copied
+    /// and must outlive its use. Mappings loaded from files or
+    /// strings take precedence over the ones of the table. Setting
+    /// a new table replaces the previous one.
+    ///
+    /// \param table  Table of mappings, sorted by id
+    /// \param count  Number of mappings in the table
+    ///
+    /// \return True if the table is valid, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool setMappingTable(const Mapping* table, std::size_t count);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Enable or disable lazy loading of text databases
+    ///
+    /// When enabled, loading a text database only indexes the GUIDs
+    /// of the lines for the current platform. The attributes of a
+    /// controller are parsed the first time it is looked up. Errors
+    /// in a line are then reported on first use, and the controller
+    /// is treated as unknown.
+    ///
+    /// Disabled by default, applies to the databases loaded afterwards.
+    ///
+    /// \param lazy  True to enable lazy loading, false to disable it
+    ///
+    ///////////////////////////////////////////////////////////
+    static void setLazyLoading(bool lazy);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Start reloading the mapping files when they change
+    ///
+    /// A background thread watches the text and compiled databases
+    /// loaded from files, including the ones loaded afterwards.
+    /// When the content of one of them changes, all the databases
+    /// are loaded again, in their original order, and the new
+    /// mappings replace the previous ones at once. Queries are
+    /// never blocked by a reload.
+    ///
+    /// Only supported on Linux.
+    ///
+    /// \return True if the files are being watched, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool startWatchingMappings();
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Stop reloading the mapping files when they change
+    ///
+    ///////////////////////////////////////////////////////////
+    static void stopWatchingMappings();
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Update the states of the gamepads
+    ///
+    /// Replaces sf::Joystick::update() when recording or replaying
+    /// the inputs: each call records or plays one frame.
+    ///
+    /// \return False if a replay has ended, true otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool update();
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Start recording the raw joystick states to a file
+    ///
+    /// Each call to update() appends a frame with the connections,
+    /// the buttons and the axes that changed, extended axes included,
+    /// and the time elapsed. The IDs, name and GUID of the joysticks
+    /// are recorded when they connect, so that the replay resolves
+    /// the same mappings. Starting a recording stops the current one.
+    ///
+    /// \param filename  Path of the file to write
+    ///
+    /// \return True if the recording has started, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool startRecording(const std::string& filename);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Stop recording the raw joystick states
+    ///
+    ///////////////////////////////////////////////////////////
+    static void stopRecording();
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Replace the joysticks by a recording
+    ///
+    /// Each call to update() plays the next recorded frame, however
+    /// long ago it was recorded, and the gamepads are read from it
+    /// with the loaded mappings. The real joysticks are ignored
+    /// until stopReplay() is called.
+    ///
+    /// The replay must not be started or stopped while sampling.
+    ///
+    /// \param filename  Path of a file written by startRecording()
+    ///
+    /// \return True if the replay has started, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool startReplay(const std::string& filename);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Stop the replay and read the real joysticks again
+    ///
+    ///////////////////////////////////////////////////////////
+    static void stopReplay();
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Select the backend that provides the joysticks
+    ///
+    /// The backend replaces sf::Joystick: its buttons and axes are
+    /// read through the loaded mappings, and its number of slots
+    /// is returned by getCount(). The controllers are identified
+    /// again on their next use. The backend must outlive its use
+    /// and must not be changed while sampling.
+    ///
+    /// \param backend  Backend to use, nullptr for sf::Joystick
+    ///
+    ///////////////////////////////////////////////////////////
+    static void setBackend(GamepadBackend* backend);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get the number of gamepad slots
+    ///
+    /// Gamepad indices range from 0 to getCount() - 1. The number
+    /// of slots is given by the backend.
+    ///
+    /// \return Number of gamepad slots
+    ///
+    ///////////////////////////////////////////////////////////
+    static unsigned int getCount();
+
     ///////////////////////////////////////////////////////////
     /// \brief Check if a gamepad is available
     ///
@@ -120,6 +366,35 @@ public:
     ////////////////////////////////////////////////////////////
     static bool isPressed(unsigned int gamepad, Control control, unsigned int deadzone = 50);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the pressed states of all the controls of a gamepad
+    ///
+    /// Chords can be tested against a mask built by getMask():
+    /// \code
+    /// const auto chord = sf::Gamepad::getMask(Control::LeftShoulder, Control::RightShoulder);
+    /// if ((sf::Gamepad::getPressedMask(0) & chord) == chord)
+    ///     ...
+    /// \endcode
+    ///
+    /// \param gamepad   Index of the gamepad
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return Pressed states, one bit per control, 0 if the gamepad is not available
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::uint32_t getPressedMask(unsigned int gamepad, unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if any control of any gamepad is pressed
+    ///
+    /// \param gamepad   If not null, receives the index of the first gamepad with a pressed control
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return True if a control is pressed, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAnyPressed(unsigned int* gamepad = nullptr, unsigned int deadzone = 50);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the current position of a control
     ///
@@ -134,6 +409,57 @@ public:
     ////////////////////////////////////////////////////////////
     static float getPosition(unsigned int gamepad, Control control);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current positions of several controls
+    ///
+    /// The mapping of the gamepad is resolved once for the whole
+    /// batch. Positions are 0 if the gamepad is not available.
+    ///
+    /// \param gamepad    Index of the gamepad
+    /// \param controls   Controls to check
+    /// \param positions  Receives the positions, in range [0 .. 100]
+    /// \param count      Number of controls
+    ///
+    ////////////////////////////////////////////////////////////
+    static void getPositions(unsigned int gamepad, const Control* controls, float* positions, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current positions of several controls on all the gamepads
+    ///
+    /// \param controls   Controls to check
+    /// \param positions  Receives getCount() * count positions, grouped by gamepad
+    /// \param count      Number of controls
+    ///
+    ////////////////////////////////////////////////////////////
+    static void getPositions(const Control* controls, float* positions, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if several controls are pressed
+    ///
+    /// The mapping of the gamepad is resolved once for the whole
+    /// batch. Controls are released if the gamepad is not available.
+    ///
+    /// \param gamepad   Index of the gamepad
+    /// \param controls  Controls to check
+    /// \param pressed   Receives the pressed states
+    /// \param count     Number of controls
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    ////////////////////////////////////////////////////////////
+    static void arePressed(unsigned int gamepad, const Control* controls, bool* pressed, std::size_t count,
+                           unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if several controls are pressed on all the gamepads
+    ///
+    /// \param controls  Controls to check
+    /// \param pressed   Receives getCount() * count pressed states, grouped by gamepad
+    /// \param count     Number of controls
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    ////////////////////////////////////////////////////////////
+    static void arePressed(const Control* controls, bool* pressed, std::size_t count, unsigned int deadzone = 50);
+
     ////////////////////////////////////////////////////////////
     /// \brief Check if a gamepad supports a given control
     ///
@@ -144,6 +470,128 @@ public:
     ///
     ////////////////////////////////////////////////////////////
     static bool hasControl(unsigned int gamepad, Control control);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Capture the state of all the controls of a gamepad
+    ///
+    /// The mapping of the gamepad is resolved once, which makes this
+    /// function much cheaper than calling getPosition() and isPressed()
+    /// for every control.
+    ///
+    /// \param gamepad   Index of the gamepad
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return State of the gamepad
+    ///
+    ////////////////////////////////////////////////////////////
+    static State capture(unsigned int gamepad, unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Capture the state of all the gamepads
+    ///
+    /// \param states    Receives one state per gamepad, indexed by gamepad
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    ////////////////////////////////////////////////////////////
+    static void captureAll(std::vector<State>& states, unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Capture all the gamepads and publish their states to other threads
+    ///
+    /// Publishing and reading snapshots lets several threads share
+    /// the gamepad states while only one of them reads sf::Joystick.
+    /// Only one thread at a time may publish.
+    ///
+    /// The snapshot is skipped when the readers still hold all the
+    /// older snapshots : the gamepads are then not captured, and the
+    /// readers keep getting the previous states until the next
+    /// successful publication.
+    ///
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return True if the states have been published, false if the snapshot has been skipped
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool publishSnapshot(unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the states of all the gamepads last published
+    ///
+    /// Any number of threads can read at the same time, without
+    /// blocking on a capture in progress. A read starts over when
+    /// a snapshot is published at the moment it starts.
+    ///
+    /// \param states  Receives one state per gamepad, indexed by gamepad
+    ///
+    /// \return True if the states have been copied, false if nothing has been published yet
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool readSnapshot(std::vector<State>& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop the next gamepad event
+    ///
+    /// When the queue is empty, the states of all the gamepads are
+    /// captured and compared with the previous capture, which fills
+    /// the queue with the controls pressed or released since then.
+    /// Like the other functions, this relies on sf::Joystick being
+    /// updated, usually by the event loop of a window.
+    ///
+    /// \param event     Receives the event
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return True if an event was returned, false if the queue is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool pollEvent(GamepadEvent& event, unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start capturing the gamepads on a background thread
+    ///
+    /// The thread calls update() and captures all the gamepads
+    /// at the given frequency. Each capture that differs from the
+    /// previous one of the same gamepad is queued as a sample, so
+    /// presses shorter than a frame are not lost. Samples are read
+    /// with pollSample().
+    ///
+    /// sf::Joystick is not thread-safe: while sampling, the other
+    /// threads should not update it, nor read it through the other
+    /// functions of this class. Mappings can still be loaded.
+    /// Note that windows update sf::Joystick in their event loop:
+    /// processing window events races with the sampling thread.
+    ///
+    /// \param frequency  Number of captures per second
+    /// \param deadzone   Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return True if the sampling thread has been started, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool startSampling(unsigned int frequency = 1000, unsigned int deadzone = 50);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the sampling thread
+    ///
+    /// The samples already captured can still be polled.
+    ///
+    ////////////////////////////////////////////////////////////
+    static void stopSampling();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop the oldest sample captured by the sampling thread
+    ///
+    /// Up to 1024 samples are kept. When they are not polled, the
+    /// sampling thread keeps capturing but pushes nothing : the
+    /// intermediate positions are dropped, and the latest state of
+    /// each gamepad is pushed once there is free room again, with
+    /// the controls pressed in the meantime still pressed. No press
+    /// is missed, their release comes in the next sample.
+    ///
+    /// \param sample  Receives the sample
+    ///
+    /// \return True if a sample was returned, false if there is none
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool pollSample(Sample& sample);
 };
 
 }
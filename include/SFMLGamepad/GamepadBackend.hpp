@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/Config.hpp>
+
+#include <SFML/Window/Joystick.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace sf
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Source of the raw joystick states read by Gamepad
+///
+/// The mappings turn the buttons and axes of a backend into
+/// gamepad controls. By default, sf::Joystick is read. Another
+/// backend is selected with Gamepad::setBackend().
+///
+/// Joysticks are identified by an index lower than getCount().
+///
+////////////////////////////////////////////////////////////
+class SFML_GAMEPAD_API GamepadBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief SDL GUID of a joystick, as written in the mapping databases
+    ///
+    /// Bytes 0-1 hold the bus type, 2-3 the CRC-16 of the name,
+    /// 4-5 the vendor ID, 8-9 the product ID and 12-13 the version,
+    /// all little-endian.
+    ///
+    ////////////////////////////////////////////////////////////
+    using Guid = std::array<std::uint8_t, 16>;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~GamepadBackend() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of joystick slots
+    ///
+    /// \return Number of joystick slots
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual unsigned int getCount() = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the states of the joysticks
+    ///
+    /// Called by Gamepad::update().
+    ///
+    /// \return False if the backend has no more states to provide, true otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool update() = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if a joystick is connected
+    ///
+    /// \param joystick  Index of the joystick
+    ///
+    /// \return True if the joystick is connected, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool isConnected(unsigned int joystick) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the identification of a joystick
+    ///
+    /// The vendor and product IDs select the mapping of the joystick.
+    ///
+    /// \param joystick  Index of the joystick
+    ///
+    /// \return Identification of the joystick
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Joystick::Identification getIdentification(unsigned int joystick) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if a joystick button is pressed
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param button    Button to check
+    ///
+    /// \return True if the button is pressed, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool isButtonPressed(unsigned int joystick, unsigned int button) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current position of a joystick axis
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param axis      Axis to check
+    ///
+    /// \return Current position of the axis, in range [-100 .. 100]
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual float getAxisPosition(unsigned int joystick, Joystick::Axis axis) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current position of an axis that sf::Joystick does not have
+    ///
+    /// Mapping databases number the axes of a joystick up to a29,
+    /// while sf::Joystick only has the equivalent of a0 to a5.
+    /// Extended axis 0 is a6, extended axis 1 is a7, and so on.
+    ///
+    /// The default implementation returns 0.
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param axis      Index of the extended axis
+    ///
+    /// \return Current position of the axis, in range [-100 .. 100]
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual float getExtendedAxisPosition(unsigned int joystick, unsigned int axis);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the SDL GUID of a joystick
+    ///
+    /// The GUID tells apart the revisions and the bus types of the
+    /// joysticks that share a vendor and product ID: the mapping of
+    /// the exact GUID is preferred, then the one of the GUID without
+    /// CRC, then without CRC and version, then the one of the vendor
+    /// and product IDs.
+    ///
+    /// The default implementation returns false, the joysticks are
+    /// then identified by their vendor and product IDs only.
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param guid      Receives the GUID
+    ///
+    /// \return True if the GUID of the joystick is known, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool getGuid(unsigned int joystick, Guid& guid);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the connection number of a joystick
+    ///
+    /// The number must change each time a joystick is plugged
+    /// in the slot, so that the mapping of the slot is resolved
+    /// again when a controller replaces another one.
+    ///
+    /// The default implementation returns false, the slots are
+    /// then checked against the identification and the GUID of
+    /// their joystick on each query.
+    ///
+    /// \param joystick    Index of the joystick
+    /// \param connection  Receives the connection number
+    ///
+    /// \return True if the connection number is known, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool getConnection(unsigned int joystick, unsigned int& connection);
+};
+
+}
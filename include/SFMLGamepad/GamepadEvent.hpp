@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/Gamepad.hpp>
+
+#include <SFML/System/Time.hpp>
+
+namespace sf
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Change of a gamepad, as returned by Gamepad::pollEvent()
+///
+////////////////////////////////////////////////////////////
+struct GamepadEvent
+{
+    enum Type
+    {
+        Connected,      //!< The gamepad became available
+        Pressed,        //!< A control was pressed
+        Released,       //!< A control was released
+        Disconnected    //!< The gamepad is no longer available
+    };
+
+    Type             type = Connected;                  //!< Type of the event
+    unsigned int     gamepad = 0;                       //!< Index of the gamepad
+    Gamepad::Control control = Gamepad::Control::None;  //!< Pressed or released control, None otherwise
+    float            position = 0.f;                    //!< Position of the control [0 .. 100]
+    Time             timestamp;                         //!< Time of the update that detected the change
+};
+
+}
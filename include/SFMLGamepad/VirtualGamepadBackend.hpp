@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/GamepadBackend.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sf
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Backend of scripted joysticks, without any device
+///
+/// Joysticks are connected, pressed and moved by the program,
+/// and go through the same mappings as real ones. Any number of
+/// joysticks can be created, for bots, load tests or headless
+/// benchmarks.
+///
+/// Changes are visible immediately, update() does nothing. The
+/// backend is not synchronized: it must not be modified while
+/// other threads read the gamepads.
+///
+////////////////////////////////////////////////////////////
+class SFML_GAMEPAD_API VirtualGamepadBackend : public GamepadBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the backend
+    ///
+    /// \param count  Number of joystick slots, all disconnected
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit VirtualGamepadBackend(unsigned int count = Joystick::Count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the number of joystick slots
+    ///
+    /// The joysticks of the removed slots are disconnected, the
+    /// new slots are disconnected.
+    ///
+    /// \param count  Number of joystick slots
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCount(unsigned int count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Connect a joystick, with all its controls released
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param vendorId  Vendor ID, selects the mapping with the product ID
+    /// \param productId Product ID
+    /// \param name      Name of the joystick
+    ///
+    ////////////////////////////////////////////////////////////
+    void connect(unsigned int joystick, unsigned int vendorId, unsigned int productId,
+        const String& name = "Virtual Joystick");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Disconnect a joystick
+    ///
+    /// \param joystick  Index of the joystick
+    ///
+    ////////////////////////////////////////////////////////////
+    void disconnect(unsigned int joystick);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Press or release a button of a joystick
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param button    Button to change, lower than sf::Joystick::ButtonCount
+    /// \param pressed   True to press the button, false to release it
+    ///
+    ////////////////////////////////////////////////////////////
+    void setButton(unsigned int joystick, unsigned int button, bool pressed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move an axis of a joystick
+    ///
+    /// \param joystick  Index of the joystick
+    /// \param axis      Axis to move
+    /// \param position  New position, in range [-100 .. 100]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAxis(unsigned int joystick, Joystick::Axis axis, float position);
+
+    unsigned int getCount() override;
+    bool update() override;
+    bool isConnected(unsigned int joystick) override;
+    Joystick::Identification getIdentification(unsigned int joystick) override;
+    bool isButtonPressed(unsigned int joystick, unsigned int button) override;
+    float getAxisPosition(unsigned int joystick, Joystick::Axis axis) override;
+    bool getConnection(unsigned int joystick, unsigned int& connection) override;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief State of a virtual joystick
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Device
+    {
+        bool                     connected = false;                 //!< Connection state
+        unsigned int             connection = 0;                    //!< Connection number
+        std::uint32_t            buttons = 0;                       //!< Pressed buttons, a bit per button
+        float                    axes[Joystick::AxisCount] = {};    //!< Axis positions
+        Joystick::Identification identification;                    //!< Identification of the joystick
+    };
+
+    std::vector<Device> _devices;         //!< Joysticks, one per slot
+    unsigned int        _connections = 0; //!< Number of joysticks connected so far
+};
+
+}
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <AxisKernel.hpp>
+
+#if defined(__AVX__)
+    #define SFML_GAMEPAD_AVX
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SFML_GAMEPAD_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define SFML_GAMEPAD_NEON
+    #include <arm_neon.h>
+#endif
+
+
+namespace sf
+{
+#if defined(SFML_GAMEPAD_AVX)
+
+////////////////////////////////////////////////////////////
+void priv::AxisKernel::split(const float* raw, std::size_t count, float deadzone, float* plus, float* minus,
+    std::uint8_t* plusBits, std::uint8_t* minusBits)
+{
+    // One joystick per register
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 threshold = _mm256_set1_ps(deadzone);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const __m256 pos = _mm256_loadu_ps(raw + i * AxisCount);
+        const __m256 neg = _mm256_sub_ps(zero, pos);
+
+        _mm256_storeu_ps(plus + i * AxisCount, _mm256_max_ps(pos, zero));
+        _mm256_storeu_ps(minus + i * AxisCount, _mm256_max_ps(neg, zero));
+
+        plusBits[i]  = static_cast<std::uint8_t>(_mm256_movemask_ps(_mm256_cmp_ps(pos, threshold, _CMP_GE_OQ)));
+        minusBits[i] = static_cast<std::uint8_t>(_mm256_movemask_ps(_mm256_cmp_ps(neg, threshold, _CMP_GE_OQ)));
+    }
+}
+
+#elif defined(SFML_GAMEPAD_SSE2)
+
+////////////////////////////////////////////////////////////
+void priv::AxisKernel::split(const float* raw, std::size_t count, float deadzone, float* plus, float* minus,
+    std::uint8_t* plusBits, std::uint8_t* minusBits)
+{
+    // One joystick per pair of registers
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 threshold = _mm_set1_ps(deadzone);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const float* in = raw + i * AxisCount;
+        const __m128 posLow  = _mm_loadu_ps(in);
+        const __m128 posHigh = _mm_loadu_ps(in + 4);
+        const __m128 negLow  = _mm_sub_ps(zero, posLow);
+        const __m128 negHigh = _mm_sub_ps(zero, posHigh);
+
+        _mm_storeu_ps(plus + i * AxisCount,      _mm_max_ps(posLow, zero));
+        _mm_storeu_ps(plus + i * AxisCount + 4,  _mm_max_ps(posHigh, zero));
+        _mm_storeu_ps(minus + i * AxisCount,     _mm_max_ps(negLow, zero));
+        _mm_storeu_ps(minus + i * AxisCount + 4, _mm_max_ps(negHigh, zero));
+
+        plusBits[i]  = static_cast<std::uint8_t>(_mm_movemask_ps(_mm_cmpge_ps(posLow, threshold))
+                                                 | _mm_movemask_ps(_mm_cmpge_ps(posHigh, threshold)) << 4);
+        minusBits[i] = static_cast<std::uint8_t>(_mm_movemask_ps(_mm_cmpge_ps(negLow, threshold))
+                                                 | _mm_movemask_ps(_mm_cmpge_ps(negHigh, threshold)) << 4);
+    }
+}
+
+#elif defined(SFML_GAMEPAD_NEON)
+
+////////////////////////////////////////////////////////////
+void priv::AxisKernel::split(const float* raw, std::size_t count, float deadzone, float* plus, float* minus,
+    std::uint8_t* plusBits, std::uint8_t* minusBits)
+{
+    // One joystick per pair of registers, lanes are weighted to gather the comparison bits
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const float32x4_t threshold = vdupq_n_f32(deadzone);
+    const uint32_t weights[4] = {1, 2, 4, 8};
+    const uint32x4_t weightsLow = vld1q_u32(weights);
+    const uint32x4_t weightsHigh = vshlq_n_u32(weightsLow, 4);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const float* in = raw + i * AxisCount;
+        const float32x4_t posLow  = vld1q_f32(in);
+        const float32x4_t posHigh = vld1q_f32(in + 4);
+        const float32x4_t negLow  = vnegq_f32(posLow);
+        const float32x4_t negHigh = vnegq_f32(posHigh);
+
+        vst1q_f32(plus + i * AxisCount,      vmaxq_f32(posLow, zero));
+        vst1q_f32(plus + i * AxisCount + 4,  vmaxq_f32(posHigh, zero));
+        vst1q_f32(minus + i * AxisCount,     vmaxq_f32(negLow, zero));
+        vst1q_f32(minus + i * AxisCount + 4, vmaxq_f32(negHigh, zero));
+
+        plusBits[i]  = static_cast<std::uint8_t>(vaddvq_u32(vandq_u32(vcgeq_f32(posLow, threshold), weightsLow))
+                                                 + vaddvq_u32(vandq_u32(vcgeq_f32(posHigh, threshold), weightsHigh)));
+        minusBits[i] = static_cast<std::uint8_t>(vaddvq_u32(vandq_u32(vcgeq_f32(negLow, threshold), weightsLow))
+                                                 + vaddvq_u32(vandq_u32(vcgeq_f32(negHigh, threshold), weightsHigh)));
+    }
+}
+
+#else
+
+////////////////////////////////////////////////////////////
+void priv::AxisKernel::split(const float* raw, std::size_t count, float deadzone, float* plus, float* minus,
+    std::uint8_t* plusBits, std::uint8_t* minusBits)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::uint8_t plusMask = 0;
+        std::uint8_t minusMask = 0;
+
+        for (std::size_t axis = 0; axis < AxisCount; axis++)
+        {
+            const float pos = raw[i * AxisCount + axis];
+            const float neg = -pos;
+
+            plus[i * AxisCount + axis]  = pos > 0.f ? pos : 0.f;
+            minus[i * AxisCount + axis] = neg > 0.f ? neg : 0.f;
+            plusMask  |= static_cast<std::uint8_t>((pos >= deadzone) << axis);
+            minusMask |= static_cast<std::uint8_t>((neg >= deadzone) << axis);
+        }
+
+        plusBits[i] = plusMask;
+        minusBits[i] = minusMask;
+    }
+}
+
+#endif
+
+}
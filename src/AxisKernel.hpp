@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Window/Joystick.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Splits raw joystick axes into directional values
+///
+/// Each axis of a joystick drives two controls, one per
+/// direction. The kernel turns a block of raw axis positions,
+/// sf::Joystick::AxisCount per joystick, into the positions of
+/// both directions and their pressed states in a single pass.
+/// It is vectorized with AVX, SSE2 or NEON when the compiler
+/// targets them.
+///
+////////////////////////////////////////////////////////////
+class AxisKernel
+{
+public:
+    static constexpr std::size_t AxisCount = Joystick::AxisCount; //!< Number of axes per joystick
+
+    static_assert(AxisCount == 8, "The kernel handles 8 axes per joystick");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Split the raw axes of several joysticks
+    ///
+    /// Positions are clamped to 0 in the opposite direction. An
+    /// axis is pressed in a direction if its position in that
+    /// direction reaches the deadzone.
+    ///
+    /// \param raw        Raw positions, AxisCount per joystick, in range [-100 .. 100]
+    /// \param count      Number of joysticks
+    /// \param deadzone   Threshold value [0 .. 100] for axis to boolean conversion
+    /// \param plus       Receives the positions in the positive direction, AxisCount per joystick
+    /// \param minus      Receives the positions in the negative direction, AxisCount per joystick
+    /// \param plusBits   Receives the pressed states in the positive direction, one bit per axis, one byte per joystick
+    /// \param minusBits  Receives the pressed states in the negative direction, one bit per axis, one byte per joystick
+    ///
+    ////////////////////////////////////////////////////////////
+    static void split(const float* raw, std::size_t count, float deadzone, float* plus, float* minus,
+                      std::uint8_t* plusBits, std::uint8_t* minusBits);
+};
+
+}
+}
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <Backend.hpp>
+#include <GamepadImpl.hpp>
+
+#include <SFML/Config.hpp>
+
+#ifdef SFML_SYSTEM_MACOS
+    #include <Apple/Controller.hpp>
+#endif
+
+
+namespace sf
+{
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Reads sf::Joystick, or the GameController framework on macOS
+////////////////////////////////////////////////////////////
+class NativeBackend : public GamepadBackend
+{
+public:
+    unsigned int getCount() override
+    {
+        return Joystick::Count;
+    }
+
+    bool update() override
+    {
+        Joystick::update();
+        return true;
+    }
+
+    bool getConnection(unsigned int joystick, unsigned int& connection) override
+    {
+        if (joystick >= Joystick::Count)
+            return false;
+
+        // sf::Joystick has no connection events : each change of the connection
+        // state seen here starts a new connection. The low bit is the last state.
+        const unsigned int connected = isConnected(joystick) ? 1 : 0;
+        auto value = _connections[joystick].load(std::memory_order_relaxed);
+        if ((value & 1u) != connected)
+        {
+            const auto next = (((value >> 1) + 1) << 1) | connected;
+            if (_connections[joystick].compare_exchange_strong(value, next, std::memory_order_relaxed))
+                value = next;
+        }
+
+        connection = value >> 1;
+        return true;
+    }
+
+#ifdef SFML_SYSTEM_MACOS
+    bool isConnected(unsigned int joystick) override
+    {
+        return priv::Controller::instance()->isConnected(joystick);
+    }
+
+    Joystick::Identification getIdentification(unsigned int joystick) override
+    {
+        return priv::Controller::instance()->getIdentification(joystick);
+    }
+
+    bool isButtonPressed(unsigned int joystick, unsigned int button) override
+    {
+        return priv::Controller::instance()->isButtonPressed(joystick, button);
+    }
+
+    float getAxisPosition(unsigned int joystick, Joystick::Axis axis) override
+    {
+        return priv::Controller::instance()->getAxisPosition(joystick, axis);
+    }
+#else
+    bool isConnected(unsigned int joystick) override
+    {
+        return Joystick::isConnected(joystick);
+    }
+
+    Joystick::Identification getIdentification(unsigned int joystick) override
+    {
+        return Joystick::getIdentification(joystick);
+    }
+
+    bool isButtonPressed(unsigned int joystick, unsigned int button) override
+    {
+        return Joystick::isButtonPressed(joystick, button);
+    }
+
+    float getAxisPosition(unsigned int joystick, Joystick::Axis axis) override
+    {
+        return Joystick::getAxisPosition(joystick, axis);
+    }
+#endif
+
+private:
+    std::atomic<unsigned int> _connections[Joystick::Count] = {}; //!< Connection number and last state of each joystick
+};
+
+NativeBackend nativeBackend;
+
+}
+
+
+////////////////////////////////////////////////////////////
+float GamepadBackend::getExtendedAxisPosition(unsigned int, unsigned int)
+{
+    return 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GamepadBackend::getGuid(unsigned int, Guid&)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GamepadBackend::getConnection(unsigned int, unsigned int&)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+std::atomic<GamepadBackend*> priv::Backend::_current{&nativeBackend};
+
+
+////////////////////////////////////////////////////////////
+void priv::Backend::set(GamepadBackend* backend)
+{
+    _current.store(backend ? backend : &nativeBackend, std::memory_order_release);
+    GamepadImpl::invalidateSlots();
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Backend::isNative()
+{
+    return &get() == &nativeBackend;
+}
+
+}
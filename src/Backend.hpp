@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/GamepadBackend.hpp>
+
+#include <atomic>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Selects the backend read by the mapping layer
+///
+/// The native backend reads sf::Joystick, or the GameController
+/// framework on macOS.
+///
+////////////////////////////////////////////////////////////
+class Backend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current backend
+    ///
+    /// \return Current backend
+    ///
+    ////////////////////////////////////////////////////////////
+    static GamepadBackend& get()
+    {
+        return *_current.load(std::memory_order_acquire);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the current backend
+    ///
+    /// The controllers are identified again on their next use.
+    ///
+    /// \param backend  New backend, nullptr for the native one
+    ///
+    ////////////////////////////////////////////////////////////
+    static void set(GamepadBackend* backend);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if the native backend is the current one
+    ///
+    /// \return True if the native backend is used, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isNative();
+
+private:
+    static std::atomic<GamepadBackend*> _current; //!< Current backend, never null
+};
+
+}
+}
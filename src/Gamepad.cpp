@@ -25,43 +25,208 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <AxisKernel.hpp>
+#include <Backend.hpp>
 #include <GamepadImpl.hpp>
+#include <MappingWatcher.hpp>
+#include <Recorder.hpp>
+#include <Replay.hpp>
+#include <Sampler.hpp>
+#include <TripleBuffer.hpp>
 #include <SFMLGamepad/Gamepad.hpp>
+#include <SFMLGamepad/GamepadEvent.hpp>
 
 #include <SFML/Window/Joystick.hpp>
+#include <SFML/System/Clock.hpp>
 #include <SFML/Config.hpp>
 
 #if defined(SFML_SYSTEM_WINDOWS)
     #include <Windows/XInput.hpp>
-#elif defined(SFML_SYSTEM_MACOS)
-    #include <Apple/Controller.hpp>
 #endif
 
-#include <functional>
-#include <cmath>
+#include <algorithm>
+#include <deque>
+#include <memory>
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+using impl = priv::GamepadImpl;
 
 namespace
 {
-using namespace std::placeholders;
-
-#ifdef SFML_SYSTEM_MACOS
-using ctrl = sf::priv::Controller;
-auto getIdentification = std::bind(&ctrl::getIdentification, ctrl::instance(), _1);
-auto getAxisPosition   = std::bind(&ctrl::getAxisPosition,   ctrl::instance(), _1, _2);
-auto isButtonPressed   = std::bind(&ctrl::isButtonPressed,   ctrl::instance(), _1, _2);
-#else
-auto getIdentification = std::bind(sf::Joystick::getIdentification, _1);
-auto getAxisPosition   = std::bind(sf::Joystick::getAxisPosition,   _1, _2);
-auto isButtonPressed   = std::bind(sf::Joystick::isButtonPressed,   _1, _2);
+#ifdef SFML_SYSTEM_WINDOWS
+////////////////////////////////////////////////////////////
+/// Check if a trigger is read through XInput. Only the
+/// devices of the native backend are XInput devices.
+////////////////////////////////////////////////////////////
+bool isXInputTrigger(unsigned int gamepad, Gamepad::Control control)
+{
+    return (control == Gamepad::Control::LeftTrigger || control == Gamepad::Control::RightTrigger)
+        && priv::Backend::isNative() && priv::XInput::isXInput(gamepad);
+}
+#endif
+
+////////////////////////////////////////////////////////////
+/// Read an analog control, oriented so that positive values
+/// are in the direction described by the control
+////////////////////////////////////////////////////////////
+float getDirectedValue(unsigned int gamepad, [[maybe_unused]] Gamepad::Control control, const impl::ControlInfo& info)
+{
+#ifdef SFML_SYSTEM_WINDOWS
+    if (isXInputTrigger(gamepad, control))
+        return priv::XInput::getPosition(gamepad, control);
 #endif
 
+    auto& backend = priv::Backend::get();
+    auto val = info.id < Joystick::AxisCount
+        ? backend.getAxisPosition(gamepad, static_cast<Joystick::Axis>(info.id))
+        : backend.getExtendedAxisPosition(gamepad, info.id - Joystick::AxisCount);
+    return info.dir ? -val : val;
 }
 
+////////////////////////////////////////////////////////////
+/// Read a control : 0 or 100 for buttons, the directed value
+/// for analog controls, 0 for unsupported controls
+////////////////////////////////////////////////////////////
+float readControl(unsigned int gamepad, Gamepad::Control control, const impl::ControlInfo& info)
+{
+    if (info.type == impl::ControlType::Button)
+        return priv::Backend::get().isButtonPressed(gamepad, info.id) ? 100.f : 0.f;
+    else if (info.type == impl::ControlType::Axis || info.type == impl::ControlType::Hat)
+        return getDirectedValue(gamepad, control, info);
 
-namespace sf
+    return 0.f;
+}
+
+////////////////////////////////////////////////////////////
+/// Convert a value returned by readControl() to a pressed state
+////////////////////////////////////////////////////////////
+bool isValuePressed(const impl::ControlInfo& info, float value, unsigned int deadzone)
 {
+    if (info.type == impl::ControlType::Button)
+        return value > 0.f;
+
+    return info.type != impl::ControlType::None && value >= deadzone;
+}
+
 ////////////////////////////////////////////////////////////
-using impl = priv::GamepadImpl;
+/// Event queue, filled by comparing the last two captures
+////////////////////////////////////////////////////////////
+std::deque<GamepadEvent> events;
+std::vector<Gamepad::State> previousStates;
+std::vector<Gamepad::State> currentStates;
+Clock eventClock;
+
+////////////////////////////////////////////////////////////
+/// Snapshots of all the gamepads, shared between threads
+////////////////////////////////////////////////////////////
+priv::TripleBuffer<std::vector<Gamepad::State>> snapshots;
+
+////////////////////////////////////////////////////////////
+/// Input recording and replay
+////////////////////////////////////////////////////////////
+priv::Recorder recorder;
+std::unique_ptr<priv::Replay> replay;
+GamepadBackend* selectedBackend = nullptr; // Backend selected by setBackend(), nullptr for the native one
+
+////////////////////////////////////////////////////////////
+/// Index of the lowest bit set in a non-zero mask
+////////////////////////////////////////////////////////////
+unsigned int lowestBit(std::uint32_t mask)
+{
+    static constexpr unsigned int positions[32] =
+    {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+
+    return positions[((mask & (~mask + 1)) * 0x077CB531u) >> 27];
+}
+
+////////////////////////////////////////////////////////////
+/// Capture the states of consecutive gamepads. The raw axes
+/// of all the gamepads are split into directional values by
+/// a single pass of the axis kernel.
+////////////////////////////////////////////////////////////
+constexpr unsigned int GroupSize = Joystick::Count;
+
+void captureGroup(unsigned int first, unsigned int count, Gamepad::State* states, unsigned int deadzone)
+{
+    constexpr auto AxisCount = priv::AxisKernel::AxisCount;
+
+    const impl::Infos* infos[GroupSize];
+    float raw[GroupSize * AxisCount] = {};
+    float plus[GroupSize * AxisCount];
+    float minus[GroupSize * AxisCount];
+    std::uint8_t plusBits[GroupSize];
+    std::uint8_t minusBits[GroupSize];
+
+    auto& backend = priv::Backend::get();
+
+    if (deadzone > 100)
+        deadzone = 100;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        infos[i] = impl::getInfos(first + i);
+        if (!infos[i])
+            continue;
+
+        for (unsigned int axis = 0; axis < AxisCount; axis++)
+            raw[i * AxisCount + axis] = backend.getAxisPosition(first + i, static_cast<Joystick::Axis>(axis));
+    }
+
+    priv::AxisKernel::split(raw, count, static_cast<float>(deadzone), plus, minus, plusBits, minusBits);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (!infos[i])
+            continue;
+
+        const auto gamepad = first + i;
+        auto& state = states[i];
+        state.available = true;
+
+        for (unsigned int c = 1; c < Gamepad::ControlCount; c++)
+        {
+            const auto control = static_cast<Gamepad::Control>(c);
+            const auto& info = impl::getControlInfo(control, *infos[i]);
+            bool pressed = false;
+
+            if (info.type == impl::ControlType::Button)
+            {
+                pressed = backend.isButtonPressed(gamepad, info.id);
+                state.positions[c] = pressed ? 100.f : 0.f;
+            }
+            else if (info.type == impl::ControlType::Axis || info.type == impl::ControlType::Hat)
+            {
+                // Extended axes and XInput triggers are not part of the raw axes
+                bool direct = info.id >= AxisCount;
+#ifdef SFML_SYSTEM_WINDOWS
+                direct = direct || isXInputTrigger(gamepad, control);
+#endif
+                if (direct)
+                {
+                    const auto val = readControl(gamepad, control, info);
+                    state.positions[c] = val > 0.f ? val : 0.f;
+                    if (isValuePressed(info, val, deadzone))
+                        state.pressed |= 1u << c;
+                    continue;
+                }
+
+                const auto index = i * AxisCount + info.id;
+                state.positions[c] = info.dir ? minus[index] : plus[index];
+                pressed = ((info.dir ? minusBits[i] : plusBits[i]) >> info.id) & 1u;
+            }
+
+            if (pressed)
+                state.pressed |= 1u << c;
+        }
+    }
+}
+
+}
 
 
 ////////////////////////////////////////////////////////////
@@ -78,6 +243,130 @@ void Gamepad::loadMappingFromString(const std::string& db)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Gamepad::loadMappingFromBinary(const std::string& filename)
+{
+    return impl::loadMappingFromBinary(filename);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::setMappingTable(const Mapping* table, std::size_t count)
+{
+    return impl::setMappingTable(table, count);
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::setLazyLoading(bool lazy)
+{
+    impl::setLazyLoading(lazy);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::startWatchingMappings()
+{
+    return priv::MappingWatcher::start();
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::stopWatchingMappings()
+{
+    priv::MappingWatcher::stop();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::update()
+{
+    auto& backend = priv::Backend::get();
+    if (!backend.update())
+        return false;
+
+    if (recorder.isOpen())
+        recorder.capture(backend);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::startRecording(const std::string& filename)
+{
+    return recorder.open(filename, getCount());
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::stopRecording()
+{
+    recorder.close();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::startReplay(const std::string& filename)
+{
+    auto next = std::make_unique<priv::Replay>();
+    if (!next->open(filename))
+        return false;
+
+    // The previous replay is destroyed once no longer used
+    priv::Backend::set(next.get());
+    replay = std::move(next);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::stopReplay()
+{
+    priv::Backend::set(selectedBackend);
+    replay.reset();
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::setBackend(GamepadBackend* backend)
+{
+    selectedBackend = backend;
+
+    // A running replay keeps the joysticks until it is stopped
+    if (!replay)
+        priv::Backend::set(backend);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Gamepad::getCount()
+{
+    return priv::Backend::get().getCount();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::startSampling(unsigned int frequency, unsigned int deadzone)
+{
+    return priv::Sampler::start(frequency, deadzone);
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::stopSampling()
+{
+    priv::Sampler::stop();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::pollSample(Sample& sample)
+{
+    return priv::Sampler::poll(sample);
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Gamepad::isAvailable(unsigned int gamepad)
 {
@@ -88,34 +377,36 @@ bool Gamepad::isAvailable(unsigned int gamepad)
 ////////////////////////////////////////////////////////////
 bool Gamepad::isPressed(unsigned int gamepad, Control control, unsigned int deadzone)
 {
-    if (gamepad >= Joystick::Count || control == Control::None)
+    if (control == Control::None)
         return false;
 
     if (deadzone > 100)
         deadzone = 100;
 
-    auto id = getIdentification(gamepad);
-    const auto& info = impl::getControlInfo(control, id);
+    const auto& info = impl::getControlInfo(control, gamepad);
 
-    if (info.type == impl::ControlType::Button)
-    {
-        return isButtonPressed(gamepad, info.id);
-    }
-    else if (info.type == impl::ControlType::Axis || info.type == impl::ControlType::Hat)
+    return isValuePressed(info, readControl(gamepad, control, info), deadzone);
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t Gamepad::getPressedMask(unsigned int gamepad, unsigned int deadzone)
+{
+    return capture(gamepad, deadzone).pressed;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::isAnyPressed(unsigned int* gamepad, unsigned int deadzone)
+{
+    for (unsigned int i = 0; i < getCount(); i++)
     {
-#ifdef SFML_SYSTEM_WINDOWS
-        if ((control == Control::LeftTrigger || control == Control::RightTrigger)
-            && priv::XInput::isXInput(gamepad))
+        if (getPressedMask(i, deadzone))
         {
-            return priv::XInput::getPosition(gamepad, control) >= deadzone;
+            if (gamepad)
+                *gamepad = i;
+            return true;
         }
-#endif
-
-        auto val = getAxisPosition(gamepad, static_cast<Joystick::Axis>(info.id));
-        if (info.dir)
-            return val <= -static_cast<int>(deadzone);
-        else
-            return val >= deadzone;
     }
 
     return false;
@@ -125,54 +416,176 @@ bool Gamepad::isPressed(unsigned int gamepad, Control control, unsigned int dead
 ////////////////////////////////////////////////////////////
 float Gamepad::getPosition(unsigned int gamepad, Control control)
 {
-    if (gamepad >= Joystick::Count || control == Control::None)
+    if (control == Control::None)
         return 0.f;
 
-    auto id = getIdentification(gamepad);
-    const auto& info = impl::getControlInfo(control, id);
+    const auto& info = impl::getControlInfo(control, gamepad);
 
-    if (info.type == impl::ControlType::Button)
+    auto val = readControl(gamepad, control, info);
+    return val > 0.f ? val : 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::getPositions(unsigned int gamepad, const Control* controls, float* positions, std::size_t count)
+{
+    const auto* infos = impl::getInfos(gamepad);
+    if (!infos)
     {
-        return isButtonPressed(gamepad, info.id) ? 100.f : 0.f;
+        std::fill(positions, positions + count, 0.f);
+        return;
     }
-    else if (info.type == impl::ControlType::Axis || info.type == impl::ControlType::Hat)
+
+    for (std::size_t i = 0; i < count; i++)
     {
-#ifdef SFML_SYSTEM_WINDOWS
-        if ((control == Control::LeftTrigger || control == Control::RightTrigger)
-            && priv::XInput::isXInput(gamepad))
-        {
-            return priv::XInput::getPosition(gamepad, control);
-        }
-#endif
-        auto val = getAxisPosition(gamepad, static_cast<Joystick::Axis>(info.id));
-        if (info.dir)
-        {
-            if (val > 0.f)
-                return 0.f;
-            return fabs(val);
-        }
-        else
-        {
-            if (val < 0.f)
-                return 0.f;
-            return val;
-        }
+        const auto val = readControl(gamepad, controls[i], impl::getControlInfo(controls[i], *infos));
+        positions[i] = val > 0.f ? val : 0.f;
     }
+}
 
-    return 0.f;
+
+////////////////////////////////////////////////////////////
+void Gamepad::getPositions(const Control* controls, float* positions, std::size_t count)
+{
+    for (unsigned int gamepad = 0; gamepad < getCount(); gamepad++)
+        getPositions(gamepad, controls, positions + gamepad * count, count);
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::arePressed(unsigned int gamepad, const Control* controls, bool* pressed, std::size_t count,
+    unsigned int deadzone)
+{
+    const auto* infos = impl::getInfos(gamepad);
+    if (!infos)
+    {
+        std::fill(pressed, pressed + count, false);
+        return;
+    }
+
+    if (deadzone > 100)
+        deadzone = 100;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const auto& info = impl::getControlInfo(controls[i], *infos);
+        pressed[i] = isValuePressed(info, readControl(gamepad, controls[i], info), deadzone);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::arePressed(const Control* controls, bool* pressed, std::size_t count, unsigned int deadzone)
+{
+    for (unsigned int gamepad = 0; gamepad < getCount(); gamepad++)
+        arePressed(gamepad, controls, pressed + gamepad * count, count, deadzone);
 }
 
 
 ////////////////////////////////////////////////////////////
 bool Gamepad::hasControl(unsigned int gamepad, Control control)
 {
-    if (gamepad >= Joystick::Count || control == Control::None)
+    if (control == Control::None)
         return false;
 
-    auto id = getIdentification(gamepad);
-    auto& info = impl::getControlInfo(control, id);
+    const auto& info = impl::getControlInfo(control, gamepad);
 
     return info.type != impl::ControlType::None;
 }
 
+
+////////////////////////////////////////////////////////////
+Gamepad::State Gamepad::capture(unsigned int gamepad, unsigned int deadzone)
+{
+    State state;
+    captureGroup(gamepad, 1, &state, deadzone);
+    return state;
+}
+
+
+////////////////////////////////////////////////////////////
+void Gamepad::captureAll(std::vector<State>& states, unsigned int deadzone)
+{
+    const auto count = getCount();
+    states.assign(count, State());
+
+    for (unsigned int first = 0; first < count; first += GroupSize)
+        captureGroup(first, std::min(GroupSize, count - first), states.data() + first, deadzone);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::publishSnapshot(unsigned int deadzone)
+{
+    // Skipped when the readers hold the older buffers : the capture would have
+    // nowhere to go, the readers keep the latest published states
+    return snapshots.publish([deadzone](std::vector<State>& states) {
+        captureAll(states, deadzone);
+    });
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::readSnapshot(std::vector<State>& states)
+{
+    return snapshots.read([&states](const std::vector<State>& snapshot) {
+        states = snapshot;
+    });
+}
+
+
+////////////////////////////////////////////////////////////
+bool Gamepad::pollEvent(GamepadEvent& event, unsigned int deadzone)
+{
+    if (events.empty())
+    {
+        captureAll(currentStates, deadzone);
+        previousStates.resize(currentStates.size());
+
+        const auto timestamp = eventClock.getElapsedTime();
+        for (unsigned int gamepad = 0; gamepad < currentStates.size(); gamepad++)
+        {
+            const auto& previous = previousStates[gamepad];
+            const auto& current = currentStates[gamepad];
+
+            GamepadEvent base;
+            base.gamepad = gamepad;
+            base.timestamp = timestamp;
+
+            if (current.available && !previous.available)
+            {
+                base.type = GamepadEvent::Connected;
+                events.push_back(base);
+            }
+
+            // Only the controls whose state changed are visited
+            for (auto changed = previous.pressed ^ current.pressed; changed; changed &= changed - 1)
+            {
+                const auto index = lowestBit(changed);
+
+                GamepadEvent change = base;
+                change.type = (current.pressed >> index) & 1u ? GamepadEvent::Pressed : GamepadEvent::Released;
+                change.control = static_cast<Control>(index);
+                change.position = current.positions[index];
+                events.push_back(change);
+            }
+
+            if (!current.available && previous.available)
+            {
+                base.type = GamepadEvent::Disconnected;
+                events.push_back(base);
+            }
+        }
+
+        previousStates.swap(currentStates);
+    }
+
+    if (events.empty())
+        return false;
+
+    event = events.front();
+    events.pop_front();
+    return true;
+}
+
 }
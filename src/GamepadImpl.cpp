@@ -26,16 +26,33 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include "GamepadImpl.hpp"
+#include "Backend.hpp"
+#include "MappedFile.hpp"
 
 #include <SFML/Config.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <cctype>
 
-#ifdef SFML_SYSTEM_MACOS
-    #include "Apple/Controller.hpp"
+#if defined(SFML_SYSTEM_WINDOWS)
+    #define PLATFORM    Windows
+#elif defined(SFML_SYSTEM_MACOS)
+    #define PLATFORM    Mac
+#elif defined(SFML_SYSTEM_ANDROID)
+    #define PLATFORM    Android
+#elif defined(SFML_SYSTEM_IOS)
+    #define PLATFORM    Ios
+#else
+    #define PLATFORM    Linux
 #endif
 
 #ifdef SFML_SYSTEM_WINDOWS
@@ -48,16 +65,184 @@
 
 namespace
 {
-using namespace std::placeholders;
+////////////////////////////////////////////////////////////
+/// Control set by an attribute of a text database line.
+/// Full axes also set the inverted direction.
+////////////////////////////////////////////////////////////
+struct Attribute
+{
+    std::string_view     name;
+    sf::Gamepad::Control control;
+    sf::Gamepad::Control inverted;
+};
 
-#ifdef SFML_SYSTEM_MACOS
-using ctrl = sf::priv::Controller;
-auto getIdentification = std::bind(&ctrl::getIdentification, ctrl::instance(), _1);
-auto isConnected       = std::bind(&ctrl::isConnected,       ctrl::instance(), _1);
-#else
-auto getIdentification = std::bind(sf::Joystick::getIdentification, _1);
-auto isConnected       = std::bind(sf::Joystick::isConnected,       _1);
-#endif
+using Control = sf::Gamepad::Control;
+
+constexpr Attribute attributes[] =
+{
+    {"a",             Control::A,             Control::None},
+    {"b",             Control::B,             Control::None},
+    {"x",             Control::X,             Control::None},
+    {"y",             Control::Y,             Control::None},
+    {"start",         Control::Start,         Control::None},
+    {"back",          Control::Back,          Control::None},
+    {"guide",         Control::Guide,         Control::None},
+    {"dpdown",        Control::Down,          Control::None},
+    {"dpleft",        Control::Left,          Control::None},
+    {"dpright",       Control::Right,         Control::None},
+    {"dpup",          Control::Up,            Control::None},
+    {"leftshoulder",  Control::LeftShoulder,  Control::None},
+    {"rightshoulder", Control::RightShoulder, Control::None},
+    {"lefttrigger",   Control::LeftTrigger,   Control::None},
+    {"righttrigger",  Control::RightTrigger,  Control::None},
+    {"leftstick",     Control::LeftStick,     Control::None},
+    {"rightstick",    Control::RightStick,    Control::None},
+    {"leftx",         Control::LeftXPlus,     Control::LeftXMinus},
+    {"lefty",         Control::LeftYPlus,     Control::LeftYMinus},
+    {"rightx",        Control::RightXPlus,    Control::RightXMinus},
+    {"righty",        Control::RightYPlus,    Control::RightYMinus},
+    {"+leftx",        Control::LeftXPlus,     Control::None},
+    {"-leftx",        Control::LeftXMinus,    Control::None},
+    {"+lefty",        Control::LeftYPlus,     Control::None},
+    {"-lefty",        Control::LeftYMinus,    Control::None},
+    {"+rightx",       Control::RightXPlus,    Control::None},
+    {"-rightx",       Control::RightXMinus,   Control::None},
+    {"+righty",       Control::RightYPlus,    Control::None},
+    {"-righty",       Control::RightYMinus,   Control::None},
+    {"touchpad",      Control::Touchpad,      Control::None},
+    {"paddle1",       Control::Paddle1,       Control::None},
+    {"paddle2",       Control::Paddle2,       Control::None},
+    {"paddle3",       Control::Paddle3,       Control::None},
+    {"paddle4",       Control::Paddle4,       Control::None},
+    {"misc1",         Control::Misc1,         Control::None},
+    {"platform",      Control::None,          Control::None}
+};
+
+////////////////////////////////////////////////////////////
+/// Perfect hash of the attribute names. The first character,
+/// the last character and the length are enough to tell them
+/// apart; the multiplier is searched at compile time so that
+/// no two names share a bucket.
+////////////////////////////////////////////////////////////
+constexpr std::size_t  AttributeTableSize = 256;
+constexpr std::uint8_t NoAttribute = 0xFF;
+
+constexpr std::uint32_t attributeHash(std::string_view name, std::uint32_t seed)
+{
+    const std::uint32_t key = static_cast<std::uint32_t>(static_cast<unsigned char>(name.front())) << 16
+                            | static_cast<std::uint32_t>(static_cast<unsigned char>(name.back())) << 8
+                            | static_cast<std::uint32_t>(name.size() & 0xFF);
+
+    return (key * seed) >> 24; // Top 8 bits : [0 .. AttributeTableSize[
+}
+
+constexpr bool isPerfectSeed(std::uint32_t seed)
+{
+    bool used[AttributeTableSize]{};
+    for (const auto& attribute : attributes)
+    {
+        const auto hash = attributeHash(attribute.name, seed);
+        if (used[hash])
+            return false;
+        used[hash] = true;
+    }
+
+    return true;
+}
+
+constexpr std::uint32_t findAttributeSeed()
+{
+    for (std::uint32_t seed = 0x9E3779B1; seed < 0x9E3779B1 + 2 * 256; seed += 2)
+    {
+        if (isPerfectSeed(seed))
+            return seed;
+    }
+
+    return 0;
+}
+
+constexpr std::uint32_t attributeSeed = findAttributeSeed();
+static_assert(attributeSeed != 0, "No perfect hash found for the attribute names");
+
+struct AttributeTable
+{
+    std::uint8_t indices[AttributeTableSize];
+
+    constexpr std::uint8_t operator[](std::size_t hash) const
+    {
+        return indices[hash];
+    }
+};
+
+constexpr AttributeTable makeAttributeTable()
+{
+    AttributeTable table{};
+    for (auto& index : table.indices)
+        index = NoAttribute;
+
+    for (std::size_t i = 0; i < std::size(attributes); i++)
+        table.indices[attributeHash(attributes[i].name, attributeSeed)] = static_cast<std::uint8_t>(i);
+
+    return table;
+}
+
+constexpr AttributeTable attributeTable = makeAttributeTable();
+
+////////////////////////////////////////////////////////////
+/// Controls described by the "aN" and "h0.N" values, indexed
+/// by N. Unsupported values have the None type.
+////////////////////////////////////////////////////////////
+using ControlInfo = sf::priv::GamepadImpl::ControlInfo;
+using ControlType = sf::priv::GamepadImpl::ControlType;
+
+constexpr ControlInfo axisControls[] =
+{
+    {ControlType::Axis, 0, sf::Joystick::X},
+    {ControlType::Axis, 0, sf::Joystick::Y},
+    {ControlType::Axis, 0, sf::Joystick::Z},
+    {ControlType::Axis, 0, sf::Joystick::U},
+    {ControlType::Axis, 0, sf::Joystick::V},
+    {ControlType::Axis, 0, sf::Joystick::R}
+};
+
+constexpr ControlInfo hatControls[] =
+{
+    {ControlType::None, 0,             0},
+    {ControlType::Hat,  POVY_UP_DIR,   sf::Joystick::PovY},
+    {ControlType::Hat,  0,             sf::Joystick::PovX},
+    {ControlType::None, 0,             0},
+    {ControlType::Hat,  POVY_DOWN_DIR, sf::Joystick::PovY},
+    {ControlType::None, 0,             0},
+    {ControlType::None, 0,             0},
+    {ControlType::None, 0,             0},
+    {ControlType::Hat,  1,             sf::Joystick::PovX}
+};
+
+////////////////////////////////////////////////////////////
+/// Value of an hex digit
+////////////////////////////////////////////////////////////
+unsigned int hexValue(char x)
+{
+    if (x >= '0' && x <= '9')
+        return static_cast<unsigned int>(x - '0');
+    if (x >= 'A' && x <= 'F')
+        return static_cast<unsigned int>(x - 'A') + 10;
+    if (x >= 'a' && x <= 'f')
+        return static_cast<unsigned int>(x - 'a') + 10;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////
+/// FNV-1a hash of a file content, used to detect the database
+/// files that actually changed
+////////////////////////////////////////////////////////////
+std::uint64_t hashContent(std::string_view content)
+{
+    std::uint64_t hash = 0xCBF29CE484222325;
+    for (const char c : content)
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3;
+    return hash;
+}
 
 }
 
@@ -65,456 +250,1083 @@ auto isConnected       = std::bind(sf::Joystick::isConnected,       _1);
 namespace sf
 {
 ////////////////////////////////////////////////////////////
-priv::GamepadImpl::Vendors priv::GamepadImpl::_db;
-unsigned int priv::GamepadImpl::_lineCount;
+std::shared_ptr<const priv::GamepadImpl::Database> priv::GamepadImpl::_db = std::make_shared<Database>();
+std::atomic<unsigned int> priv::GamepadImpl::_generation{1};
+std::mutex priv::GamepadImpl::_updateMutex;
+std::atomic<priv::GamepadImpl::Platform> priv::GamepadImpl::_platform{priv::GamepadImpl::Platform::PLATFORM};
+std::atomic<bool> priv::GamepadImpl::_lazy{false};
+thread_local std::deque<priv::GamepadImpl::Slot> priv::GamepadImpl::_slots;
+std::deque<std::string> priv::GamepadImpl::_names(1);
+std::unordered_map<std::string_view, uint32_t> priv::GamepadImpl::_nameIndex;
+std::mutex priv::GamepadImpl::_namesMutex;
 
 
 ////////////////////////////////////////////////////////////
-void priv::GamepadImpl::loadMappingFromFile(const std::string& filename)
+bool priv::GamepadImpl::loadMappingFromFile(const std::string& filename)
 {
-    std::ifstream db(filename);
-    if (!db.is_open())
+    // Lines are parsed in place, out of the mapped pages
+    MappedFile file;
+    if (!file.open(filename))
     {
         std::cerr << "Could not load '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    updateDatabase([&](Database& db) {
+        parseBuffer(file.getContent(), db);
+        buildIndex(db);
+        db.sources.push_back({SourceType::File, filename, nullptr, hashContent(file.getContent())});
+    });
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::loadMappingFromString(const std::string& text)
+{
+    // The string is kept, for the databases loaded after it to keep
+    // taking precedence when the files are reloaded
+    auto copy = std::make_shared<const std::string>(text);
+
+    updateDatabase([&](Database& db) {
+        parseBuffer(*copy, db);
+        buildIndex(db);
+        db.sources.push_back({SourceType::String, std::string(), std::move(copy), 0});
+    });
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::parseBuffer(std::string_view text, Database& db)
+{
+    const std::size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const std::size_t threadCount = std::min(hardwareThreads, text.size() / MinChunkSize + 1);
+
+    if (threadCount == 1)
+    {
+        ParseContext context{db.entries, db.lazyText, std::cerr, 0};
+        parseLines(text, context);
         return;
     }
 
-    _lineCount = 0;
-    while (!db.eof())
+    ////////////////////////////////////////////////////////////
+    // Large buffers are split at line boundaries, each chunk is
+    // parsed by its own thread into its own entries and log
+    ////////////////////////////////////////////////////////////
+    struct Chunk
+    {
+        std::string_view   text;        // Lines of the chunk
+        unsigned int       firstLine;   // Number of the line before the chunk
+        std::vector<Entry> entries;     // Parsed entries
+        std::string        lazyText;    // Lines of the pending entries
+        std::ostringstream log;         // Error messages
+    };
+
+    std::vector<Chunk> chunks(threadCount);
+    std::size_t begin = 0;
+    unsigned int line = 0;
+
+    for (std::size_t i = 0; i < threadCount; i++)
     {
-        std::string line;
-        std::getline(db, line);
-        parseLine(line);
+        auto end = text.size();
+        if (i + 1 < threadCount)
+        {
+            end = text.find('\n', begin + (text.size() - begin) / (threadCount - i));
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+        }
+
+        chunks[i].text = text.substr(begin, end - begin);
+        chunks[i].firstLine = line;
+        line += static_cast<unsigned int>(std::count(chunks[i].text.begin(), chunks[i].text.end(), '\n'));
+        begin = end;
+    }
+
+    const auto parseChunk = [](Chunk& chunk) {
+        ParseContext context{chunk.entries, chunk.lazyText, chunk.log, chunk.firstLine};
+        parseLines(chunk.text, context);
+    };
+
+    std::vector<std::thread> threads;
+    for (auto& chunk : chunks)
+    {
+        try
+        {
+            threads.emplace_back(parseChunk, std::ref(chunk));
+        }
+        catch (const std::system_error&)
+        {
+            parseChunk(chunk); // No thread available : parse the chunk here
+        }
     }
 
-    db.close();
+    for (auto& thread : threads)
+        thread.join();
+
+    // Merging in the chunk order keeps the last line of the buffer winning
+    for (auto& chunk : chunks)
+    {
+        const auto base = static_cast<uint32_t>(db.lazyText.size());
+        db.lazyText += chunk.lazyText;
+
+        for (auto& entry : chunk.entries)
+        {
+            if (entry.state == EntryState::Pending)
+                entry.offset += base;
+            db.entries.push_back(std::move(entry));
+        }
+
+        std::cerr << chunk.log.str();
+    }
 }
 
 
 ////////////////////////////////////////////////////////////
-void priv::GamepadImpl::loadMappingFromString(const std::string& db)
+void priv::GamepadImpl::parseLines(std::string_view text, ParseContext& context)
 {
-    _lineCount = 0;
-    const char* begin = db.c_str();
-    const char* end   = begin;
+    while (!text.empty())
+    {
+        auto end = text.find('\n');
+        if (end == std::string_view::npos)
+            end = text.size();
 
-    while (*begin)
+        parseLine(text.substr(0, end), context);
+        text.remove_prefix(std::min(end + 1, text.size()));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::loadMappingFromBinary(const std::string& filename)
+{
+    // The file is read once, for both its entries and its hash
+    MappedFile file;
+    if (!file.open(filename))
     {
-        while (*end && *end != '\n')
-            end++;
-        parseLine(std::string(begin, end));
-        begin = end++;
+        std::cerr << "Could not load '" << filename << "'" << std::endl;
+        return false;
     }
+
+    // Parsed before the update, so that an invalid database publishes nothing
+    Database parsed;
+    if (!parseBinary(file.getContent(), filename, parsed))
+        return false;
+
+    updateDatabase([&](Database& db) {
+        db.entries.insert(db.entries.end(), std::make_move_iterator(parsed.entries.begin()),
+                          std::make_move_iterator(parsed.entries.end()));
+        buildIndex(db);
+        db.sources.push_back({SourceType::Binary, filename, nullptr, hashContent(file.getContent())});
+    });
+
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
-bool priv::GamepadImpl::isAvailable(unsigned int gamepad)
+bool priv::GamepadImpl::parseBinary(std::string_view content, const std::string& filename, Database& db)
 {
-    if (gamepad >= sf::Joystick::Count)
+    static_assert(sizeof(BinaryHeader) == 16, "Unexpected compiled database header layout");
+    static_assert(sizeof(BinaryEntry) == 20 + Gamepad::ControlCount, "Unexpected compiled database entry layout");
+
+    BinaryHeader header{};
+    if (content.size() >= sizeof(header))
+        std::memcpy(&header, content.data(), sizeof(header));
+
+    if (content.size() < sizeof(header) || header.magic != BinaryMagic)
+    {
+        std::cerr << "'" << filename << "' is not a compiled mapping database" << std::endl;
         return false;
+    }
 
-    if (!isConnected(gamepad))
+    if (header.version != BinaryVersion || header.controlCount != Gamepad::ControlCount)
+    {
+        std::cerr << "'" << filename << "' has an unsupported version (" << header.version << ")" << std::endl;
         return false;
+    }
 
-    auto id = getIdentification(gamepad);
-    auto vid = _db.find(id.vendorId);
-    if (vid == _db.end())
+    if (header.platform != static_cast<uint8_t>(_platform.load()))
+    {
+        std::cerr << "'" << filename << "' contains mappings for another platform" << std::endl;
+        return false;
+    }
+
+    const uint64_t recordsSize = static_cast<uint64_t>(header.entryCount) * sizeof(BinaryEntry);
+    if (recordsSize + header.namesSize > content.size() - sizeof(header))
+    {
+        std::cerr << "'" << filename << "' is truncated" << std::endl;
         return false;
+    }
+
+    // Records are copied out of the content, which has no alignment guarantee
+    const char* records = content.data() + sizeof(header);
+    const auto names = content.substr(sizeof(header) + static_cast<std::size_t>(recordsSize), header.namesSize);
+    std::vector<BinaryEntry> entries(header.entryCount);
+    if (!entries.empty())
+        std::memcpy(entries.data(), records, static_cast<std::size_t>(recordsSize));
+
+    // Nothing is appended unless every record is valid : a corrupted
+    // database is rejected as a whole, not loaded in part
+    const auto corrupted = std::any_of(entries.begin(), entries.end(), [&names](const BinaryEntry& entry) {
+        return entry.name >= names.size();
+    });
+
+    if (corrupted)
+    {
+        std::cerr << "'" << filename << "' is corrupted" << std::endl;
+        return false;
+    }
+
+    db.entries.reserve(db.entries.size() + entries.size());
+    for (const auto& entry : entries)
+    {
+        Infos infos;
+        infos.platform = _platform;
+        infos.name = internName(names.substr(entry.name, names.find('\0', entry.name) - entry.name));
+        for (unsigned int c = 1; c < Gamepad::ControlCount; c++)
+            infos.controls[c] = decodeControl(entry.controls[c]);
+
+        db.entries.push_back({entry.guid, infos});
+    }
+
+    return true;
+}
 
-    auto pid = vid->second.find(id.productId);
-    if (pid == vid->second.end())
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::hashFile(const std::string& filename, uint64_t& hash)
+{
+    // The watched files may be rewritten at any time : a truncated mapping would raise SIGBUS
+    MappedFile file;
+    if (!file.open(filename, false))
         return false;
 
+    hash = hashContent(file.getContent());
     return true;
 }
 
 
 ////////////////////////////////////////////////////////////
-priv::GamepadImpl::ControlInfo& priv::GamepadImpl::getControlInfo(Gamepad::Control control,
-    Joystick::Identification& id)
+bool priv::GamepadImpl::saveMappingToBinary(const std::string& filename)
 {
-    static ControlInfo empty{0};
+    const auto db = std::atomic_load(&_db);
+    std::vector<BinaryEntry> entries;
+    std::string names;
+    std::unordered_map<uint32_t, uint32_t> nameOffsets;
+
+    // Names are stored once, most of the database shares a few of them
+    names.reserve(db->entries.size() * 16);
+    for (const auto& entry : db->entries)
+    {
+        if (!resolveEntry(*db, entry))
+            continue;
 
-    auto vid = _db.find(id.vendorId);
-    if (vid == _db.end())
-        return empty;
+        auto offset = nameOffsets.find(entry.infos.name);
+        if (offset == nameOffsets.end())
+        {
+            offset = nameOffsets.emplace(entry.infos.name, static_cast<uint32_t>(names.size())).first;
+            names += getName(entry.infos);
+            names += '\0';
+        }
 
-    auto pid = vid->second.find(id.productId);
-    if (pid == vid->second.end())
-        return empty;
+        BinaryEntry binaryEntry{entry.guid, offset->second, {}};
+        for (unsigned int c = 1; c < Gamepad::ControlCount; c++)
+            binaryEntry.controls[c] = encodeControl(entry.infos.controls[c]);
+        entries.push_back(binaryEntry);
+    }
 
-    auto& infos = pid->second;
-
-    switch (control)
-    {
-        case Gamepad::Control::A:             return infos.a;
-        case Gamepad::Control::B:             return infos.b;
-        case Gamepad::Control::X:             return infos.x;
-        case Gamepad::Control::Y:             return infos.y;
-        case Gamepad::Control::Back:          return infos.back;
-        case Gamepad::Control::Start:         return infos.start;
-        case Gamepad::Control::Guide:         return infos.guide;
-        case Gamepad::Control::Up:            return infos.dpup;
-        case Gamepad::Control::Down:          return infos.dpdown;
-        case Gamepad::Control::Left:          return infos.dpleft;
-        case Gamepad::Control::Right:         return infos.dpright;
-        case Gamepad::Control::LeftStick:     return infos.leftstick;
-        case Gamepad::Control::RightStick:    return infos.rightstick;
-        case Gamepad::Control::LeftShoulder:  return infos.leftshoulder;
-        case Gamepad::Control::RightShoulder: return infos.rightshoulder;
-        case Gamepad::Control::LeftTrigger:   return infos.lefttrigger;
-        case Gamepad::Control::RightTrigger:  return infos.righttrigger;
-        case Gamepad::Control::LeftXMinus:    return infos.leftxneg;
-        case Gamepad::Control::LeftXPlus:     return infos.leftxpos;
-        case Gamepad::Control::LeftYMinus:    return infos.leftyneg;
-        case Gamepad::Control::LeftYPlus:     return infos.leftypos;
-        case Gamepad::Control::RightXMinus:   return infos.rightxneg;
-        case Gamepad::Control::RightXPlus:    return infos.rightxpos;
-        case Gamepad::Control::RightYMinus:   return infos.rightyneg;
-        case Gamepad::Control::RightYPlus:    return infos.rightypos;
-        case Gamepad::Control::Touchpad:      return infos.touchpad;
-        case Gamepad::Control::Paddle1:       return infos.paddle1;
-        case Gamepad::Control::Paddle2:       return infos.paddle2;
-        case Gamepad::Control::Paddle3:       return infos.paddle3;
-        case Gamepad::Control::Paddle4:       return infos.paddle4;
-        case Gamepad::Control::Misc1:         return infos.misc1;
-        default:
-            return empty;
-    }
-}
-
-
-////////////////////////////////////////////////////////////
-std::vector<std::string> priv::GamepadImpl::tokenize(const std::string& text, const char delim)
-{
-    if (text.empty())
-        return {};
-
-    std::vector<std::string> tokens;
-    const char* str = text.c_str();
-
-    do
-    {
-        while (isspace(*str))
-            str++;
-        const char* begin = str;
-
-        while (*str && (*str != delim))
-            str++;
-
-        const char* end = str - 1;
-        while ((end > begin) && (isspace(*end) || *end == '\0'))
-            end--;
+    BinaryHeader header;
+    header.magic        = BinaryMagic;
+    header.version      = BinaryVersion;
+    header.platform     = static_cast<uint8_t>(_platform.load());
+    header.controlCount = Gamepad::ControlCount;
+    header.entryCount   = static_cast<uint32_t>(entries.size());
+    header.namesSize    = static_cast<uint32_t>(names.size());
 
-        if (*begin && (*begin != delim))
-            tokens.push_back(std::string(begin, end+1));
+    std::ofstream file(filename, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BinaryEntry)));
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
 
-    } while (*str++);
+    if (!file)
+    {
+        std::cerr << "Could not write '" << filename << "'" << std::endl;
+        return false;
+    }
 
-    return tokens;
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
-void priv::GamepadImpl::parseLine(const std::string& line)
+bool priv::GamepadImpl::saveMappingToHeader(const std::string& filename, const std::string& symbol)
 {
-       _lineCount++;
+    const auto db = std::atomic_load(&_db);
 
-        auto tokens = tokenize(line, ',');
+    // Tables are searched by VID/PID : only the entry that a VID/PID lookup finds is kept
+    std::vector<const Entry*> entries;
+    for (const auto& product : db->productIndex)
+    {
+        const auto& entry = db->entries[product.second];
+        if (resolveEntry(*db, entry))
+            entries.push_back(&entry);
+    }
 
-        if (tokens.empty() || tokens[0][0] == '#') // Empty line or comment
-            return;
+    std::sort(entries.begin(), entries.end(), [](const Entry* lhs, const Entry* rhs) {
+        return makeKey(lhs->guid) < makeKey(rhs->guid);
+    });
 
-        uint16_t    vid;
-        uint16_t    pid;
-        Infos       infos;
-        auto&       guid = tokens[0];
+    const auto count = entries.size();
 
-        if (!parseGUID(guid, vid, pid))
-        {
-            std::cerr << "Invalid GUID '" << guid << "', line " << _lineCount << std::endl;
-            return;
-        }
+    std::ofstream file(filename);
 
-        if (tokens.size() < 2)
-        {
-            std::cerr << "Missing name for GUID '" << guid << "', line " << _lineCount << std::endl;
-            return;
-        }
-        infos.name = tokens[1];
+    file << "// Generated by sfml-gamepad-dbc, do not edit" << std::endl
+         << "// " << count << " mappings for " << getPlatformName(_platform) << std::endl
+         << std::endl
+         << "#pragma once" << std::endl
+         << std::endl
+         << "#include <SFMLGamepad/Gamepad.hpp>" << std::endl
+         << std::endl
+         << "#include <array>" << std::endl
+         << std::endl
+         << "inline constexpr std::array<sf::Gamepad::Mapping, " << count << "> " << symbol << " =" << std::endl
+         << "{{" << std::endl;
 
-        if (tokens.size() < 3)
+    const auto flags = file.flags();
+    for (const auto* entry : entries)
+    {
+        file << "    {0x" << std::hex << std::setw(8) << std::setfill('0') << makeKey(entry->guid) << std::dec << ", \"";
+        for (char c : getName(entry->infos))
         {
-            std::cerr << "No attributes for GUID '" << guid << "', line " << _lineCount << std::endl;
-            return;
+            if (c == '"' || c == '\\')
+                file << '\\';
+            file << c;
         }
+        file << "\", {";
 
-        bool error = false;
-        for (int i = 2; i < tokens.size() && !error; i++)
+        for (unsigned int c = 0; c < Gamepad::ControlCount; c++)
         {
-            if (!parseAttr(tokens[i], infos))
-            {
-                std::cerr << "Invalid argument or value for GUID '" << guid << "', argument '"
-                    << tokens[i] << "', line " << _lineCount << std::endl;
-                error = true;
-            }
+            const auto code = c ? encodeControl(entry->infos.controls[c]) : 0;
+            file << (c ? ", " : "") << static_cast<unsigned int>(code);
         }
 
-        if (error)
-            return;
+        file << "}}," << std::endl;
+    }
+    file.flags(flags);
 
-#if defined(SFML_SYSTEM_WINDOWS)
-        if (infos.platform != Platform::Windows)
-            return;
-#elif defined(SFML_SYSTEM_MACOS)
-        if (infos.platform != Platform::Mac)
-            return;
-#elif defined(SFML_SYSTEM_ANDROID)
-        if (infos.platform != Platform::Android)
-            return;
-#elif defined(SFML_SYSTEM_IOS)
-        if (infos.platform != Platform::Ios)
-            return;
-#else
-        if (infos.platform != Platform::Linux)
-            return;
-#endif
-        _db[vid][pid] = infos;
+    file << "}};" << std::endl;
+
+    if (!file)
+    {
+        std::cerr << "Could not write '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
-bool priv::GamepadImpl::parseGUID(const std::string& guid, uint16_t& vid, uint16_t& pid)
+bool priv::GamepadImpl::setMappingTable(const Gamepad::Mapping* table, std::size_t count)
 {
-    // Check GUID format : 32 hex digits
-    if (guid.size() != 32)
+    const auto sorted = std::is_sorted(table, table + count, [](const Gamepad::Mapping& lhs, const Gamepad::Mapping& rhs) {
+        return lhs.id < rhs.id;
+    });
+
+    if (!sorted)
+    {
+        std::cerr << "Mapping table is not sorted by id" << std::endl;
         return false;
+    }
 
-    for (int i = 0; i < 32; i++)
-        if (!isxdigit(guid[i]))
-            return false;
+    updateDatabase([table, count](Database& db) {
+        db.table = table;
+        db.tableSize = count;
+    });
+    return true;
+}
 
-    // Hex digit to int conversion
-    const auto x2d = [](char x) -> uint16_t {
-        if (isdigit(x))
-            return x - '0';
-        if (x >= 'A' && x <= 'F')
-            return (x - 'A') + 10;
-        if (x >= 'a' && x <= 'f')
-            return (x - 'a') + 10;
-        return 0;
-    };
 
-    // Extract VID/PID from GUID
-    vid = 0;
-    vid |= x2d(guid[8])  * 0x0010;
-    vid |= x2d(guid[9])  * 0x0001;
-    vid |= x2d(guid[10]) * 0x1000;
-    vid |= x2d(guid[11]) * 0x0100;
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::setLazyLoading(bool lazy)
+{
+    _lazy = lazy;
+}
 
-    pid = 0;
-    pid |= x2d(guid[16]) * 0x0010;
-    pid |= x2d(guid[17]) * 0x0001;
-    pid |= x2d(guid[18]) * 0x1000;
-    pid |= x2d(guid[19]) * 0x0100;
 
-    return true;
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::setPlatform(Platform platform)
+{
+    _platform = platform;
 }
 
 
 ////////////////////////////////////////////////////////////
-bool priv::GamepadImpl::parseAttr(const std::string& attrStr, Infos& infos)
+bool priv::GamepadImpl::parsePlatform(std::string_view name, Platform& platform)
 {
-    auto tokens = tokenize(attrStr, ':');
-    if (tokens.size() != 2)
+    if (name == "Windows")
+        platform = Platform::Windows;
+    else if (name == "Mac OS X")
+        platform = Platform::Mac;
+    else if (name == "Linux")
+        platform = Platform::Linux;
+    else if (name == "Android")
+        platform = Platform::Android;
+    else if (name == "iOS")
+        platform = Platform::Ios;
+    else
         return false;
 
-    auto& attr = tokens[0];
-    auto& val  = tokens[1];
-
-    if (attr == "platform")
-    {
-        if (val == "Windows")
-            infos.platform = Platform::Windows;
-        else if (val == "Mac OS X")
-            infos.platform = Platform::Mac;
-        else if (val == "Linux")
-            infos.platform = Platform::Linux;
-        else if (val == "Android")
-            infos.platform = Platform::Android;
-        else if (val == "iOS")
-            infos.platform = Platform::Ios;
-        else
-            return false;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::string_view priv::GamepadImpl::getPlatformName(Platform platform)
+{
+    switch (platform)
+    {
+        case Platform::Windows: return "Windows";
+        case Platform::Mac:     return "Mac OS X";
+        case Platform::Android: return "Android";
+        case Platform::Ios:     return "iOS";
+        default:                return "Linux";
     }
-    else
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t priv::GamepadImpl::getEntryCount()
+{
+    return std::atomic_load(&_db)->entries.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::getMappingFiles(std::vector<std::string>& filenames)
+{
+    const auto db = std::atomic_load(&_db);
+
+    filenames.clear();
+    for (const auto& source : db->sources)
     {
-        ControlInfo control{0};
+        if (source.type != SourceType::String)
+            filenames.push_back(source.filename);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::reloadMappingFiles()
+{
+    std::lock_guard<std::mutex> lock(_updateMutex);
+    const auto current = std::atomic_load(&_db);
+
+    // Saving a file without changing it, or touching it, does not reload anything
+    const auto changed = std::any_of(current->sources.begin(), current->sources.end(), [](const Source& source) {
+        uint64_t hash = 0;
+        return source.type != SourceType::String && hashFile(source.filename, hash) && hash != source.hash;
+    });
+
+    if (!changed)
+        return false;
+
+    auto next = std::make_shared<Database>();
+    next->table = current->table;
+    next->tableSize = current->tableSize;
+    next->sources = current->sources;
 
-        if (val[0] == 'b' && val.size() >= 2)
+    // A file that can no longer be read is left out of the
+    // mappings, but stays a source to be reloaded later
+    for (auto& source : next->sources)
+    {
+        if (source.type == SourceType::String)
         {
-            control.type = ControlType::Button;
-            control.id = atoi(&val[1]);
+            parseBuffer(*source.text, *next);
+            continue;
         }
-        else if (val[0] == 'h' && val.size() >= 4)
+
+        // Read rather than mapped, like in hashFile()
+        MappedFile file;
+        if (!file.open(source.filename, false))
         {
-            if (val[1] != '0' || val[2] != '.')
-                return false;
-
-            control.type = ControlType::Hat;
-            switch(atoi(&val[3]))
-            {
-                case 1:
-                    control.id = static_cast<int>(Joystick::PovY);
-                    control.dir = POVY_UP_DIR;
-                    break;
-                case 2:
-                    control.id = static_cast<int>(Joystick::PovX);
-                    control.dir = 0;
-                    break;
-                case 4:
-                    control.id = static_cast<int>(Joystick::PovY);
-                    control.dir = POVY_DOWN_DIR;
-                    break;
-                case 8:
-                    control.id = static_cast<int>(Joystick::PovX);
-                    control.dir = 1;
-                    break;
-                default:
-                    return false;
-            }
+            std::cerr << "Could not reload '" << source.filename << "'" << std::endl;
+            continue;
         }
-        else if (val[0] == 'a' && val.size() >= 2)
+
+        source.hash = hashContent(file.getContent());
+        if (source.type == SourceType::File)
+            parseBuffer(file.getContent(), *next);
+        else
+            parseBinary(file.getContent(), source.filename, *next);
+    }
+
+    buildIndex(*next);
+    publishDatabase(std::move(next));
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::isAvailable(unsigned int gamepad)
+{
+    return getInfos(gamepad) != nullptr;
+}
+
+
+////////////////////////////////////////////////////////////
+const priv::GamepadImpl::Infos* priv::GamepadImpl::getInfos(unsigned int gamepad)
+{
+    auto& backend = Backend::get();
+    if (gamepad >= backend.getCount())
+        return nullptr;
+
+    // The slots grow with the number of joysticks of the backends. A deque
+    // keeps the existing slots in place : their infos may point to their storage
+    if (gamepad >= _slots.size())
+        _slots.resize(gamepad + 1);
+
+    auto& slot = _slots[gamepad];
+    const bool connected = backend.isConnected(gamepad);
+    const auto generation = _generation.load(std::memory_order_acquire);
+
+    // Another controller may have been plugged in the slot since the last resolution
+    unsigned int connection = 0;
+    const bool tracked = !connected || backend.getConnection(gamepad, connection);
+    bool changed = slot.connected != connected || slot.connection != connection;
+
+    Joystick::Identification id;
+    GamepadBackend::Guid guid{};
+    bool identified = false;
+    if (connected && (!tracked || changed || slot.generation != generation))
+    {
+        id = backend.getIdentification(gamepad);
+        identified = backend.getGuid(gamepad, guid);
+
+        // Without connection numbers, the controllers are told apart by their IDs and GUID
+        if (!tracked)
+            changed = changed || slot.vendorId != id.vendorId || slot.productId != id.productId ||
+                slot.identified != identified || slot.guid != guid;
+    }
+
+    // Fast path : the database is only loaded when it changed since the last resolution
+    if (slot.generation != generation || changed)
+    {
+        slot.db = std::atomic_load(&_db);
+        slot.infos = connected ? findInfos(*slot.db, id, identified ? &guid : nullptr, slot.decoded) : nullptr;
+        slot.connected = connected;
+        slot.connection = connection;
+        slot.vendorId = id.vendorId;
+        slot.productId = id.productId;
+        slot.identified = identified;
+        slot.guid = guid;
+        slot.generation = generation;
+    }
+
+    return slot.infos;
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::invalidateSlots()
+{
+    _generation.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+const priv::GamepadImpl::ControlInfo& priv::GamepadImpl::getControlInfo(Gamepad::Control control,
+    unsigned int gamepad)
+{
+    static const ControlInfo empty{0};
+
+    auto infos = getInfos(gamepad);
+    if (!infos)
+        return empty;
+
+    return getControlInfo(control, *infos);
+}
+
+
+////////////////////////////////////////////////////////////
+const std::string& priv::GamepadImpl::getName(const Infos& infos)
+{
+    std::lock_guard<std::mutex> lock(_namesMutex);
+    return _names[infos.name];
+}
+
+
+////////////////////////////////////////////////////////////
+uint32_t priv::GamepadImpl::internName(std::string_view name)
+{
+    if (name.empty())
+        return 0;
+
+    std::lock_guard<std::mutex> lock(_namesMutex);
+
+    // The deque never moves its strings : the keys stay valid
+    auto it = _nameIndex.find(name);
+    if (it == _nameIndex.end())
+    {
+        _names.emplace_back(name);
+        it = _nameIndex.emplace(_names.back(), static_cast<uint32_t>(_names.size() - 1)).first;
+    }
+
+    return it->second;
+}
+
+
+////////////////////////////////////////////////////////////
+const priv::GamepadImpl::Infos* priv::GamepadImpl::findInfos(const Database& db, const Joystick::Identification& id,
+    const GamepadBackend::Guid* guid, Infos& storage)
+{
+    const auto probe = [&db](const auto& index, const auto& key) -> const Infos* {
+        const auto it = index.find(key);
+        if (it == index.end() || !resolveEntry(db, db.entries[it->second]))
+            return nullptr;
+        return &db.entries[it->second].infos;
+    };
+
+    // From the most to the least specific : the controller, its revision, the product on its bus, the product
+    if (guid)
+    {
+        if (const auto* infos = probe(db.exactIndex, *guid))
+            return infos;
+        if (const auto* infos = probe(db.exactIndex, clearCrc(*guid)))
+            return infos;
+        if (const auto* infos = probe(db.revisionIndex, stripGuid(*guid)))
+            return infos;
+    }
+
+    const auto key = makeKey(static_cast<uint16_t>(id.vendorId), static_cast<uint16_t>(id.productId));
+    if (const auto* infos = probe(db.productIndex, key))
+        return infos;
+
+    const auto* tableEnd = db.table + db.tableSize;
+    const auto* mapping = std::lower_bound(db.table, tableEnd, key, [](const Gamepad::Mapping& lhs, uint32_t rhs) {
+        return lhs.id < rhs;
+    });
+    if (mapping == tableEnd || mapping->id != key)
+        return nullptr;
+
+    // The name is left out, it is not used by queries
+    storage.platform = _platform;
+    for (unsigned int c = 1; c < Gamepad::ControlCount; c++)
+        storage.controls[c] = decodeControl(mapping->controls[c]);
+
+    return &storage;
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::buildIndex(Database& db)
+{
+    auto& entries = db.entries;
+
+    // New entries are appended in parsing order : walking backwards
+    // keeps the last parsed entry of each GUID
+    db.exactIndex.clear();
+    db.exactIndex.reserve(entries.size());
+
+    std::size_t count = entries.size();
+    for (std::size_t i = entries.size(); i-- > 0;)
+    {
+        if (!db.exactIndex.emplace(entries[i].guid, 0).second)
+            continue;
+        count--;
+        if (count != i)
+            entries[count] = std::move(entries[i]);
+    }
+    entries.erase(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(count));
+    entries.shrink_to_fit();
+
+    // Only the lines still pending are kept : the lines of the replaced
+    // and parsed entries would otherwise pile up across the loads
+    std::size_t pendingSize = 0;
+    for (const auto& entry : entries)
+        if (entry.state == EntryState::Pending)
+            pendingSize += entry.length;
+
+    std::string lazyText;
+    lazyText.reserve(pendingSize);
+    for (auto& entry : entries)
+    {
+        if (entry.state != EntryState::Pending)
+            continue;
+        const auto offset = static_cast<uint32_t>(lazyText.size());
+        lazyText.append(db.lazyText, entry.offset, entry.length);
+        entry.offset = offset;
+    }
+    db.lazyText = std::move(lazyText);
+
+    // The entries are still in parsing order : the last one of each key wins.
+    // Mappings with a CRC only apply to the controllers with that name.
+    db.revisionIndex.clear();
+    db.productIndex.clear();
+    db.revisionIndex.reserve(entries.size());
+    db.productIndex.reserve(entries.size());
+
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        const auto& guid = entries[i].guid;
+        const auto index = static_cast<uint32_t>(i);
+        db.exactIndex[guid] = index;
+        if (clearCrc(guid) != guid)
+            continue;
+
+        db.revisionIndex[stripGuid(guid)] = index;
+        db.productIndex[makeKey(guid)] = index;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Update>
+void priv::GamepadImpl::updateDatabase(Update&& update)
+{
+    std::lock_guard<std::mutex> lock(_updateMutex);
+
+    const auto current = std::atomic_load(&_db);
+    auto next = std::make_shared<Database>();
+    {
+        // Readers may be parsing pending entries of the current version
+        std::lock_guard<std::mutex> lazyLock(current->lazyMutex);
+        next->entries = current->entries;
+        next->lazyText = current->lazyText;
+    }
+    next->exactIndex = current->exactIndex;
+    next->revisionIndex = current->revisionIndex;
+    next->productIndex = current->productIndex;
+    next->table = current->table;
+    next->tableSize = current->tableSize;
+    next->sources = current->sources;
+
+    update(*next);
+    publishDatabase(std::move(next));
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::publishDatabase(std::shared_ptr<const Database> db)
+{
+    std::atomic_store(&_db, std::move(db));
+    _generation.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t priv::GamepadImpl::tokenize(std::string_view text, const char delim,
+    std::string_view* tokens, std::size_t capacity)
+{
+    const auto isSpace = [](char c) { return isspace(static_cast<unsigned char>(c)) != 0; };
+
+    std::size_t count = 0;
+    std::size_t pos = 0;
+
+    while (pos < text.size())
+    {
+        while (pos < text.size() && isSpace(text[pos]))
+            pos++;
+        const std::size_t begin = pos;
+
+        while (pos < text.size() && text[pos] != delim)
+            pos++;
+
+        std::size_t end = pos;
+        while (end > begin && isSpace(text[end - 1]))
+            end--;
+
+        if (end > begin)
         {
-            control.type = ControlType::Axis;
-            switch(atoi(&val[1]))
-            {
-                case 0: control.id = static_cast<int>(Joystick::X); break;
-                case 1: control.id = static_cast<int>(Joystick::Y); break;
-                case 2: control.id = static_cast<int>(Joystick::Z); break;
-                case 3: control.id = static_cast<int>(Joystick::U); break;
-                case 4: control.id = static_cast<int>(Joystick::V); break;
-                case 5: control.id = static_cast<int>(Joystick::R); break;
-                default:
-                    return false;
-            }
+            if (count < capacity)
+                tokens[count] = text.substr(begin, end - begin);
+            count++;
         }
-        else if ((val[0] == '-' || val[0] == '+') && val.size() >= 3 && val[1] == 'a')
+
+        pos++;
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int priv::GamepadImpl::parseNumber(std::string_view text)
+{
+    unsigned int value = 0;
+    for (char c : text)
+    {
+        if (c < '0' || c > '9')
+            break;
+        value = value * 10 + static_cast<unsigned int>(c - '0');
+    }
+
+    return value;
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::GamepadImpl::parseLine(std::string_view line, ParseContext& context)
+{
+    context.line++;
+
+    const auto first = line.find_first_not_of(" \t\r\v\f");
+    if (first == std::string_view::npos || line[first] == '#') // Empty line or comment
+        return;
+
+    // Most lines of the reference database are meant for other platforms,
+    // skip them before tokenizing and parsing their attributes
+    if (!isCurrentPlatform(line))
+        return;
+
+    Entry entry;
+
+    if (_lazy)
+    {
+        // Only the GUID is parsed now, the line is kept for resolveEntry()
+        std::string_view guid;
+
+        tokenize(line, ',', &guid, 1);
+        if (!parseKey(line, guid, entry.guid))
         {
-            control.type = ControlType::Axis;
-            if (val[0] == '-')
-                control.dir = 1;
-
-            switch(atoi(&val[2]))
-            {
-                case 0: control.id = static_cast<int>(Joystick::X); break;
-                case 1: control.id = static_cast<int>(Joystick::Y); break;
-                case 2: control.id = static_cast<int>(Joystick::Z); break;
-                case 3: control.id = static_cast<int>(Joystick::U); break;
-                case 4: control.id = static_cast<int>(Joystick::V); break;
-                case 5: control.id = static_cast<int>(Joystick::R); break;
-                default:
-                    return false;
-            }
+            context.log << "Invalid GUID or CRC '" << guid << "', line " << context.line << std::endl;
+            return;
         }
-        else
+
+        entry.state  = EntryState::Pending;
+        entry.offset = static_cast<uint32_t>(context.lazyText.size());
+        entry.length = static_cast<uint32_t>(line.size());
+        entry.line   = context.line;
+        context.lazyText.append(line);
+    }
+    else if (!parseEntry(line, context.line, entry.guid, entry.infos, context.log))
+    {
+        return;
+    }
+
+    context.entries.push_back(std::move(entry));
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::parseEntry(std::string_view line, unsigned int lineNumber, GamepadBackend::Guid& key,
+    Infos& infos, std::ostream& log)
+{
+    std::string_view tokens[MaxTokens];
+    const auto count = tokenize(line, ',', tokens, MaxTokens);
+
+    const auto  guid = tokens[0];
+
+    if (!parseKey(line, guid, key))
+    {
+        log << "Invalid GUID or CRC '" << guid << "', line " << lineNumber << std::endl;
+        return false;
+    }
+
+    if (count < 2)
+    {
+        log << "Missing name for GUID '" << guid << "', line " << lineNumber << std::endl;
+        return false;
+    }
+
+    if (count < 3)
+    {
+        log << "No attributes for GUID '" << guid << "', line " << lineNumber << std::endl;
+        return false;
+    }
+
+    if (count > MaxTokens)
+    {
+        log << "Too many attributes for GUID '" << guid << "', line " << lineNumber << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 2; i < count; i++)
+    {
+        if (!parseAttr(tokens[i], infos))
         {
+            log << "Invalid argument or value for GUID '" << guid << "', argument '"
+                << tokens[i] << "', line " << lineNumber << std::endl;
             return false;
         }
+    }
 
-        if (attr == "a")
-            infos.a = control;
-        else if (attr == "b")
-            infos.b = control;
-        else if (attr == "x")
-            infos.x = control;
-        else if (attr == "y")
-            infos.y = control;
-        else if (attr == "start")
-            infos.start = control;
-        else if (attr == "back")
-            infos.back = control;
-        else if (attr == "guide")
-            infos.guide = control;
-        else if (attr == "dpdown")
-            infos.dpdown = control;
-        else if (attr == "dpleft")
-            infos.dpleft = control;
-        else if (attr == "dpright")
-            infos.dpright = control;
-        else if (attr == "dpup")
-            infos.dpup = control;
-        else if (attr == "leftshoulder")
-            infos.leftshoulder = control;
-        else if (attr == "rightshoulder")
-            infos.rightshoulder = control;
-        else if (attr == "lefttrigger")
-            infos.lefttrigger = control;
-        else if (attr == "righttrigger")
-            infos.righttrigger = control;
-        else if (attr == "leftstick")
-            infos.leftstick = control;
-        else if (attr == "rightstick")
-            infos.rightstick = control;
-        else if (attr == "leftx")
-        {
-            ControlInfo controlNeg = control;
-            controlNeg.dir = 1;
-            infos.leftxpos = control;
-            infos.leftxneg = controlNeg;
-        }
-        else if (attr == "lefty")
+    if (infos.platform != _platform)
+        return false;
+
+    // The name is only copied for the entries that are kept
+    infos.name = internName(tokens[1]);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::resolveEntry(const Database& db, const Entry& entry)
+{
+    // Without pending lines, the entries of a published database never change
+    if (db.lazyText.empty())
+        return entry.state == EntryState::Parsed;
+
+    std::lock_guard<std::mutex> lock(db.lazyMutex);
+    if (entry.state == EntryState::Pending)
+    {
+        const std::string_view line(db.lazyText.data() + entry.offset, entry.length);
+        GamepadBackend::Guid guid;
+
+        const bool valid = parseEntry(line, entry.line, guid, entry.infos, std::cerr);
+        entry.state = valid ? EntryState::Parsed : EntryState::Invalid;
+    }
+
+    return entry.state == EntryState::Parsed;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::isCurrentPlatform(std::string_view line)
+{
+    std::string_view value;
+    return findField(line, "platform", value) && value == getPlatformName(_platform);
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::findField(std::string_view line, std::string_view name, std::string_view& value)
+{
+    constexpr std::string_view spaces = " \t\r\v\f";
+
+    for (auto pos = line.find(name); pos != std::string_view::npos; pos = line.find(name, pos + 1))
+    {
+        // The attribute must start a field...
+        const auto before = line.substr(0, pos).find_last_not_of(spaces);
+        if (before == std::string_view::npos || line[before] != ',')
+            continue;
+
+        // ... and be followed by a value
+        value = line.substr(pos + name.size());
+        value.remove_prefix(std::min(value.find_first_not_of(spaces), value.size()));
+        if (value.empty() || value[0] != ':')
+            continue;
+
+        value = value.substr(1, value.find(',') - 1);
+        value.remove_prefix(std::min(value.find_first_not_of(spaces), value.size()));
+        value = value.substr(0, value.find_last_not_of(spaces) + 1);
+        return true;
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::parseKey(std::string_view line, std::string_view text, GamepadBackend::Guid& guid)
+{
+    if (!parseGUID(text, guid))
+        return false;
+
+    // A mapping with a CRC only applies to the controllers whose name has that CRC
+    std::string_view crc;
+    if (!findField(line, "crc", crc))
+        return true;
+
+    if (crc.size() != 4 || !std::all_of(crc.begin(), crc.end(), [](char c) { return isxdigit(static_cast<unsigned char>(c)); }))
+        return false;
+
+    guid[2] = static_cast<uint8_t>(hexValue(crc[2]) << 4 | hexValue(crc[3]));
+    guid[3] = static_cast<uint8_t>(hexValue(crc[0]) << 4 | hexValue(crc[1]));
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::parseGUID(std::string_view text, GamepadBackend::Guid& guid)
+{
+    // Check GUID format : 32 hex digits
+    if (text.size() != 32)
+        return false;
+
+    for (int i = 0; i < 32; i++)
+        if (!isxdigit(static_cast<unsigned char>(text[i])))
+            return false;
+
+    // Bytes are written in memory order
+    for (std::size_t i = 0; i < guid.size(); i++)
+        guid[i] = static_cast<uint8_t>(hexValue(text[2 * i]) << 4 | hexValue(text[2 * i + 1]));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::GamepadImpl::parseAttr(std::string_view attrStr, Infos& infos)
+{
+    std::string_view tokens[2];
+    if (tokenize(attrStr, ':', tokens, 2) != 2)
+        return false;
+
+    const auto attr = tokens[0];
+    const auto val  = tokens[1];
+
+    if (attr.empty() || val.size() < 2)
+        return false;
+
+    // The CRC is part of the GUID, see parseKey()
+    if (attr == "crc")
+        return true;
+
+    const auto index = attributeTable[attributeHash(attr, attributeSeed)];
+    if (index == NoAttribute || attributes[index].name != attr)
+        return false;
+
+    const auto& attribute = attributes[index];
+    if (attribute.control == Control::None)
+        return parsePlatform(val, infos.platform);
+
+    // Half axes are only valid on axes
+    const bool half = (val[0] == '+' || val[0] == '-');
+    const auto kind = val[half];
+    ControlInfo control{0};
+
+    if (kind == 'b' && !half)
+    {
+        control.type = ControlType::Button;
+        control.id = parseNumber(val.substr(1));
+    }
+    else if (kind == 'a' && val.size() > 1u + half)
+    {
+        const auto axis = parseNumber(val.substr(1u + half));
+        if (axis < std::size(axisControls))
         {
-            ControlInfo controlNeg = control;
-            controlNeg.dir = 1;
-            infos.leftypos = control;
-            infos.leftyneg = controlNeg;
+            control = axisControls[axis];
         }
-        else if (attr == "rightx")
+        else if (axis < std::size(axisControls) + ExtendedAxisCount)
         {
-            ControlInfo controlNeg = control;
-            controlNeg.dir = 1;
-            infos.rightxpos = control;
-            infos.rightxneg = controlNeg;
+            // Axes that sf::Joystick does not have are read as extended axes of the backend
+            control.type = ControlType::Axis;
+            control.id = Joystick::AxisCount + (axis - std::size(axisControls));
         }
-        else if (attr == "righty")
+        else
         {
-            ControlInfo controlNeg = control;
-            controlNeg.dir = 1;
-            infos.rightypos = control;
-            infos.rightyneg = controlNeg;
+            return false;
         }
-        else if (attr == "+leftx")
-            infos.leftxpos = control;
-        else if (attr == "-leftx")
-            infos.leftxneg = control;
-        else if (attr == "+lefty")
-            infos.leftypos = control;
-        else if (attr == "-lefty")
-            infos.leftyneg = control;
-        else if (attr == "+rightx")
-            infos.rightxpos = control;
-        else if (attr == "-rightx")
-            infos.rightxneg = control;
-        else if (attr == "+righty")
-            infos.rightypos = control;
-        else if (attr ==  "-righty")
-            infos.rightyneg = control;
-        else if (attr == "touchpad")
-            infos.touchpad = control;
-        else if (attr == "paddle1")
-            infos.paddle1 = control;
-        else if (attr == "paddle2")
-            infos.paddle2 = control;
-        else if (attr == "paddle3")
-            infos.paddle3 = control;
-        else if (attr == "paddle4")
-            infos.paddle4 = control;
-        else if (attr == "misc1")
-            infos.misc1 = control;
-        else
+
+        control.dir = (val[0] == '-');
+    }
+    else if (kind == 'h' && !half && val.size() >= 4 && val[1] == '0' && val[2] == '.')
+    {
+        const auto mask = parseNumber(val.substr(3));
+        if (mask >= std::size(hatControls))
             return false;
+
+        control = hatControls[mask];
+    }
+
+    if (control.type == ControlType::None)
+        return false;
+
+    infos.controls[static_cast<unsigned int>(attribute.control)] = control;
+    if (attribute.inverted != Control::None)
+    {
+        control.dir = 1;
+        infos.controls[static_cast<unsigned int>(attribute.inverted)] = control;
     }
 
     return true;
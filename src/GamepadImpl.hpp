@@ -28,13 +28,21 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFMLGamepad/Gamepad.hpp>
+#include <SFMLGamepad/GamepadBackend.hpp>
 
 #include <SFML/Window/Joystick.hpp>
 
+#include <atomic>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <map>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include <cstring>
 
 namespace sf
 {
@@ -64,7 +72,7 @@ public:
     /// \brief Describes a platform as used in the Infos struct
     ///
     ////////////////////////////////////////////////////////////
-    enum class Platform
+    enum class Platform : uint8_t
     {
         Linux,      //!< Platform: Linux
         Windows,    //!< Platform: Windows
@@ -81,48 +89,20 @@ public:
     {
         uint8_t type : 2; ///< One of the ControlType values
         uint8_t dir  : 1; ///< Direction for axis : 0 = positive, 1 = negative
-        uint8_t id   : 5; ///< Button or axis number
+        uint8_t id   : 5; ///< Button or axis number, extended axes start at sf::Joystick::AxisCount
     };
 
+    static constexpr unsigned int ExtendedAxisCount = 32 - Joystick::AxisCount; //!< Number of axes beyond the ones of sf::Joystick
+
     ////////////////////////////////////////////////////////////
     /// \brief Contains the informations about a controller
     ///
     ////////////////////////////////////////////////////////////
     struct Infos
     {
-        Platform platform;                  //!< Platform used by this controller
-        std::string name;                   //!< Name of the controller
-        ControlInfo a{0};                   //!< 'A' control description
-        ControlInfo b{0};                   //!< 'B' control description
-        ControlInfo x{0};                   //!< 'X' control description
-        ControlInfo y{0};                   //!< 'Y' control description
-        ControlInfo start{0};               //!< 'Start' control description
-        ControlInfo back{0};                //!< 'Back' control description
-        ControlInfo guide{0};               //!< 'Guide' control description
-        ControlInfo dpdown{0};              //!< 'Dpad down' control description
-        ControlInfo dpleft{0};              //!< 'Dpad left' control description
-        ControlInfo dpright{0};             //!< 'Dpad right' control description
-        ControlInfo dpup{0};                //!< 'Dpad up' control description
-        ControlInfo leftshoulder{0};        //!< 'Left shoulder' control description
-        ControlInfo rightshoulder{0};       //!< 'Right shoulder' control description
-        ControlInfo lefttrigger{0};         //!< 'Left trigger' control description
-        ControlInfo righttrigger{0};        //!< 'Right trigger' control description
-        ControlInfo leftstick{0};           //!< Left stick as a button control description
-        ControlInfo rightstick{0};          //!< Right stick as a button control description
-        ControlInfo leftxpos{0};            //!< Left stick, X axis, positive direction control description
-        ControlInfo leftxneg{0};            //!< Left stick, X axis, negative direction control description
-        ControlInfo leftypos{0};            //!< Left stick, Y axis, positive direction control description
-        ControlInfo leftyneg{0};            //!< Left stick, Y axis, negative direction control description
-        ControlInfo rightxpos{0};           //!< Right stick, X axis, positive direction control description
-        ControlInfo rightxneg{0};           //!< Right stick, X axis, negative direction control description
-        ControlInfo rightypos{0};           //!< Right stick, Y axis, positive direction control description
-        ControlInfo rightyneg{0};           //!< Right stick, Y axis, negative direction control description
-        ControlInfo touchpad{0};            //!< Touchpad control description
-        ControlInfo paddle1{0};             //!< Paddle 1 control description
-        ControlInfo paddle2{0};             //!< Paddle 2 control description
-        ControlInfo paddle3{0};             //!< Paddle 3 control description
-        ControlInfo paddle4{0};             //!< Paddle 4 control description
-        ControlInfo misc1{0};               //!< Miscellaneous control 1 description
+        Platform    platform = Platform::Linux;         //!< Platform used by this controller
+        uint32_t    name = 0;                           //!< Name of the controller, index in the name pool
+        ControlInfo controls[Gamepad::ControlCount]{};  //!< Control descriptions, indexed by Gamepad::Control
     };
 
     ///////////////////////////////////////////////////////////
@@ -130,8 +110,10 @@ public:
     ///
     /// \param filename  Path of the database to load
     ///
+    /// \return True if the file could be read, false otherwise
+    ///
     ///////////////////////////////////////////////////////////
-    static void loadMappingFromFile(const std::string& filename);
+    static bool loadMappingFromFile(const std::string& filename);
 
     ///////////////////////////////////////////////////////////
     /// \brief Load a mapping database from a string
@@ -141,6 +123,110 @@ public:
     ///////////////////////////////////////////////////////////
     static void loadMappingFromString(const std::string& db);
 
+    ///////////////////////////////////////////////////////////
+    /// \brief Load a compiled mapping database from a file
+    ///
+    /// \param filename  Path of the database to load
+    ///
+    /// \return True if the database has been loaded, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool loadMappingFromBinary(const std::string& filename);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Save the loaded mappings as a compiled database
+    ///
+    /// \param filename  Path of the file to write
+    ///
+    /// \return True if the database has been written, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool saveMappingToBinary(const std::string& filename);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Save the loaded mappings as a C++ header
+    ///
+    /// The header defines a constexpr std::array of Gamepad::Mapping,
+    /// sorted by id, to be passed to setMappingTable().
+    ///
+    /// \param filename  Path of the file to write
+    /// \param symbol    Name of the array
+    ///
+    /// \return True if the header has been written, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool saveMappingToHeader(const std::string& filename, const std::string& symbol);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Use a mapping table
+    ///
+    /// \param table  Table of mappings, sorted by id
+    /// \param count  Number of mappings in the table
+    ///
+    /// \return True if the table is valid, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool setMappingTable(const Gamepad::Mapping* table, std::size_t count);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Enable or disable lazy loading
+    ///
+    /// \param lazy  True to parse the attributes of a controller on first use
+    ///
+    ///////////////////////////////////////////////////////////
+    static void setLazyLoading(bool lazy);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Select the platform whose mappings are loaded
+    ///
+    /// Defaults to the platform the library is built for. Tools
+    /// use it to process the mappings of other platforms.
+    ///
+    /// \param platform  Platform to select
+    ///
+    ///////////////////////////////////////////////////////////
+    static void setPlatform(Platform platform);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get a platform from its name in a text database
+    ///
+    /// \param name      Name of the platform, i.e. "Mac OS X"
+    /// \param platform  Stores the platform
+    ///
+    /// \return True if the name is valid, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool parsePlatform(std::string_view name, Platform& platform);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get the number of controllers in the database
+    ///
+    /// \return Number of controllers
+    ///
+    ///////////////////////////////////////////////////////////
+    static std::size_t getEntryCount();
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get the paths of the loaded database files
+    ///
+    /// \param filenames  Receives the paths of the text and compiled databases
+    ///
+    ///////////////////////////////////////////////////////////
+    static void getMappingFiles(std::vector<std::string>& filenames);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Reload the databases if one of their files changed
+    ///
+    /// The content of each loaded file is compared with the content
+    /// that was loaded. When one differs, all the databases are
+    /// loaded again in their original order into a new version,
+    /// which is then swapped in.
+    ///
+    /// \return True if the databases have been reloaded, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool reloadMappingFiles();
+
     ///////////////////////////////////////////////////////////
     /// \brief Check if a gamepad is available
     ///
@@ -154,50 +240,373 @@ public:
     ///////////////////////////////////////////////////////////
     static bool isAvailable(unsigned int gamepad);
 
+    ///////////////////////////////////////////////////////////
+    /// \brief Get the informations about the controller of a slot
+    ///
+    /// The result is cached per slot, and resolved again only when
+    /// the slot gets connected or disconnected, when another
+    /// controller is plugged in the slot or when a mapping is loaded.
+    ///
+    /// \param gamepad  Index of the gamepad
+    ///
+    /// \return Pointer to the controller infos, or nullptr if the gamepad is not available
+    ///
+    ///////////////////////////////////////////////////////////
+    static const Infos* getInfos(unsigned int gamepad);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Identify the controllers again on their next use
+    ///
+    /// Must be called when the joystick backend changes.
+    ///
+    ///////////////////////////////////////////////////////////
+    static void invalidateSlots();
+
     ///////////////////////////////////////////////////////////
     /// \brief Get informations about a control
     ///
     /// \param control  Control type
-    /// \param id       sf::Joystick identification
+    /// \param gamepad  Index of the gamepad
+    ///
+    /// \return ControlInfo struct for the control type
+    ///
+    ///////////////////////////////////////////////////////////
+    static const ControlInfo& getControlInfo(Gamepad::Control control, unsigned int gamepad);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get informations about a control of a known controller
+    ///
+    /// \param control  Control type
+    /// \param infos    Controller infos
     ///
     /// \return ControlInfo struct for the control type
     ///
     ///////////////////////////////////////////////////////////
-    static ControlInfo& getControlInfo(Gamepad::Control control, sf::Joystick::Identification& id);
+    static const ControlInfo& getControlInfo(Gamepad::Control control, const Infos& infos)
+    {
+        return infos.controls[static_cast<unsigned int>(control)];
+    }
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get the name of a controller
+    ///
+    /// \param infos  Controller infos
+    ///
+    /// \return Name of the controller, empty if unknown
+    ///
+    ///////////////////////////////////////////////////////////
+    static const std::string& getName(const Infos& infos);
 
 private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Parsing state of a database entry
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class EntryState : uint8_t
+    {
+        Parsed,     //!< The infos are valid
+        Pending,    //!< Lazy loading : the line has not been parsed yet
+        Invalid     //!< Lazy loading : the line failed to parse
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Database entry
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        GamepadBackend::Guid guid{};                        //!< GUID of the controller
+        mutable Infos        infos;                         //!< Controller infos, valid once parsed
+        mutable EntryState   state = EntryState::Parsed;    //!< Parsing state
+        uint32_t             offset = 0;                    //!< Pending entry : offset of the line in lazyText
+        uint32_t             length = 0;                    //!< Pending entry : length of the line
+        uint32_t             line = 0;                      //!< Pending entry : line number, for error messages
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Hash of a GUID, for the database indices
+    ///
+    ////////////////////////////////////////////////////////////
+    struct GuidHash
+    {
+        std::size_t operator()(const GamepadBackend::Guid& guid) const
+        {
+            uint64_t low;
+            uint64_t high;
+            std::memcpy(&low, guid.data(), sizeof(low));
+            std::memcpy(&high, guid.data() + sizeof(low), sizeof(high));
+
+            const uint64_t hash = (low ^ (high * 0x9E3779B97F4A7C15)) * 0xBF58476D1CE4E5B9;
+            return static_cast<std::size_t>(hash ^ (hash >> 32));
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Describes how a database has been loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class SourceType : uint8_t
+    {
+        File,   //!< Text database loaded from a file
+        String, //!< Text database loaded from a string
+        Binary  //!< Compiled database loaded from a file
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Database loaded into the mappings, kept to reload them
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Source
+    {
+        SourceType                         type = SourceType::File; //!< How the database has been loaded
+        std::string                        filename;                //!< Path of the file, if any
+        std::shared_ptr<const std::string> text;                    //!< Content of the string, if any
+        uint64_t                           hash = 0;                //!< Hash of the file content when loaded
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Version of the mapping database
+    ///
+    /// A published database is never modified, except for its
+    /// pending entries which are parsed on first use under the
+    /// lazy mutex. Loads build a new version and swap it in.
+    ///
+    /// The indices map to positions in the entries. When several
+    /// entries share a key, the last parsed one is indexed. Entries
+    /// with a CRC are only in the exact index.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Database
+    {
+        using GuidIndex = std::unordered_map<GamepadBackend::Guid, uint32_t, GuidHash>;
+
+        std::vector<Entry>      entries;            //!< Loaded mappings, one per GUID, in parsing order
+        GuidIndex               exactIndex;         //!< Entries by GUID
+        GuidIndex               revisionIndex;      //!< Entries by GUID without CRC and version, see stripGuid()
+        std::unordered_map<uint32_t, uint32_t> productIndex; //!< Entries by VID/PID key, see makeKey()
+        std::string             lazyText;           //!< Lines of the pending entries
+        const Gamepad::Mapping* table = nullptr;    //!< Mapping table, sorted by id
+        std::size_t             tableSize = 0;      //!< Number of mappings in the table
+        std::vector<Source>     sources;            //!< Loaded databases, in loading order
+        mutable std::mutex      lazyMutex;          //!< Protects the pending entries
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destination of the lines parsed from a text database
+    ///
+    /// Each parsing thread has its own context.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct ParseContext
+    {
+        std::vector<Entry>& entries;    //!< Receives the parsed entries
+        std::string&        lazyText;   //!< Receives the lines of the pending entries
+        std::ostream&       log;        //!< Receives the error messages
+        unsigned int        line;       //!< Number of the last parsed line
+    };
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Store a controller name in the name pool
+    ///
+    /// Identical names are stored once. Can be called from several
+    /// parsing threads.
+    ///
+    /// \param name  Name to store
+    ///
+    /// \return Index of the name in the pool
+    ///
+    ///////////////////////////////////////////////////////////
+    static uint32_t internName(std::string_view name);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Look up the informations about a controller in the database
+    ///
+    /// The loaded mappings are probed by exact GUID, then by GUID
+    /// without CRC, then without CRC and version, then by VID/PID.
+    /// The mapping table is searched last, by VID/PID. Mappings found in the table are
+    /// decoded into the storage.
+    ///
+    /// \param db       Database to search
+    /// \param id       sf::Joystick identification
+    /// \param guid     GUID of the controller, nullptr if unknown
+    /// \param storage  Receives the infos decoded from the mapping table
+    ///
+    /// \return Pointer to the controller infos, or nullptr if it is unknown
+    ///
+    ///////////////////////////////////////////////////////////
+    static const Infos* findInfos(const Database& db, const sf::Joystick::Identification& id,
+                                  const GamepadBackend::Guid* guid, Infos& storage);
+
     ///////////////////////////////////////////////////////////
     /// \brief Splits a text string into tokens
     ///
-    /// Leading and trailing whitespaces are removed
+    /// Leading and trailing whitespaces are removed, empty tokens
+    /// are skipped. Tokens are views into the text.
     ///
-    /// \param text   String to split
-    /// \param delim  Delimiter character
+    /// \param text      String to split
+    /// \param delim     Delimiter character
+    /// \param tokens    Receives the tokens
+    /// \param capacity  Maximum number of tokens that can be stored
     ///
-    /// \return Vector of token strings
+    /// \return Number of tokens found, which may exceed capacity
     ///
     ///////////////////////////////////////////////////////////
-    static std::vector<std::string> tokenize(const std::string& text, const char delim);
+    static std::size_t tokenize(std::string_view text, const char delim,
+                                std::string_view* tokens, std::size_t capacity);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Parse the decimal number at the beginning of a string
+    ///
+    /// \param text  String to parse
+    ///
+    /// \return Parsed value, 0 if the string does not start with a digit
+    ///
+    ///////////////////////////////////////////////////////////
+    static unsigned int parseNumber(std::string_view text);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Parse a text database into a database version
+    ///
+    /// Large buffers are parsed on several threads. The entries
+    /// are appended, buildIndex() must be called after.
+    ///
+    /// \param text  Text of the database to parse
+    /// \param db    Database that receives the entries
+    ///
+    ///////////////////////////////////////////////////////////
+    static void parseBuffer(std::string_view text, Database& db);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Read a compiled database into a database version
+    ///
+    /// The entries are appended, buildIndex() must be called after.
+    /// Nothing is appended if the database is not valid.
+    ///
+    /// \param content   Content of the compiled database
+    /// \param filename  Path of the database, for error messages
+    /// \param db        Database that receives the entries
+    ///
+    /// \return True if the database has been read, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool parseBinary(std::string_view content, const std::string& filename, Database& db);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Hash the content of a file
+    ///
+    /// \param filename  Path of the file
+    /// \param hash      Receives the hash of the content
+    ///
+    /// \return True if the file could be read, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool hashFile(const std::string& filename, uint64_t& hash);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Parse the lines of a text database
+    ///
+    /// \param text     Lines to parse
+    /// \param context  Parsing context
+    ///
+    ///////////////////////////////////////////////////////////
+    static void parseLines(std::string_view text, ParseContext& context);
 
     ///////////////////////////////////////////////////////////
     /// \brief Parse a full line of a text database
     ///
-    /// \param line Line to parse
+    /// \param line     Line to parse
+    /// \param context  Parsing context
+    ///
+    ///////////////////////////////////////////////////////////
+    static void parseLine(std::string_view line, ParseContext& context);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Get the name of a platform in a text database
+    ///
+    /// \param platform  Platform
+    ///
+    /// \return Name of the platform
+    ///
+    ///////////////////////////////////////////////////////////
+    static std::string_view getPlatformName(Platform platform);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Parse the fields of a line of a text database
+    ///
+    /// \param line        Line to parse, neither empty nor a comment
+    /// \param lineNumber  Number of the line, for error messages
+    /// \param guid        Stores the GUID, see parseKey()
+    /// \param infos       Stores the controller infos
+    /// \param log         Receives the error messages
+    ///
+    /// \return True if the line is valid and targets the current platform, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool parseEntry(std::string_view line, unsigned int lineNumber, GamepadBackend::Guid& guid, Infos& infos,
+                           std::ostream& log);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Parse a pending entry, if not already done
+    ///
+    /// \param db     Database of the entry
+    /// \param entry  Entry to resolve
+    ///
+    /// \return True if the infos of the entry are valid, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool resolveEntry(const Database& db, const Entry& entry);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Check if a line of a text database targets the current platform
+    ///
+    /// Only looks for the platform field, the line is not validated.
+    ///
+    /// \param line  Line to check
+    ///
+    /// \return True if the platform of the line is the current one, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool isCurrentPlatform(std::string_view line);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Find the value of a field in a line of a text database
+    ///
+    /// The line is not validated.
+    ///
+    /// \param line   Line to search
+    /// \param name   Name of the field, i.e. "platform"
+    /// \param value  Stores the value of the field, without spaces
+    ///
+    /// \return True if the field has been found, false otherwise
     ///
     ///////////////////////////////////////////////////////////
-    static void parseLine(const std::string& line);
+    static bool findField(std::string_view line, std::string_view name, std::string_view& value);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Parse the GUID of a line of a text database
+    ///
+    /// The "crc" field of the line, if any, is stored in the GUID,
+    /// like SDL does.
+    ///
+    /// \param line  Line to parse
+    /// \param text  First field of the line
+    /// \param guid  Stores the GUID
+    ///
+    /// \return True if the GUID and the CRC are valid, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool parseKey(std::string_view line, std::string_view text, GamepadBackend::Guid& guid);
 
     ///////////////////////////////////////////////////////////
     /// \brief Parse a GUID string
     ///
-    /// \param guid  GUID to parse
-    /// \param pid   Stores the extracted PID
-    /// \param vid   Stores the extracted VID
+    /// \param text  GUID to parse, 32 hex digits
+    /// \param guid  Stores the GUID
     ///
     /// \return True if the GUID is valid, false otherwise
     ///
     ///////////////////////////////////////////////////////////
-    static bool parseGUID(const std::string& guid, uint16_t& pid, uint16_t& vid);
+    static bool parseGUID(std::string_view text, GamepadBackend::Guid& guid);
 
     ///////////////////////////////////////////////////////////
     /// \brief Parse an attribute/value pair string, i.e. start:b10
@@ -208,13 +617,199 @@ private:
     /// \return True if the attribute/value pair string is valid, false otherwise
     ///
     ///////////////////////////////////////////////////////////
-    static bool parseAttr(const std::string& attrStr, Infos& infos);
+    static bool parseAttr(std::string_view attrStr, Infos& infos);
 
-    using Products = std::map<uint16_t, Infos>;     //!< Maps gamepad infos to a PID
-    using Vendors = std::map<uint16_t, Products>;   //!< Maps PIDs to a VID
+    ///////////////////////////////////////////////////////////
+    /// \brief Merge the database entries and rebuild the lookup indices
+    ///
+    /// Entries that share a GUID are merged, the last one parsed
+    /// wins. The lines that are no longer pending are dropped from
+    /// the lazy text.
+    ///
+    /// \param db  Database to index
+    ///
+    ///////////////////////////////////////////////////////////
+    static void buildIndex(Database& db);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Build a new version of the database and publish it
+    ///
+    /// The new version starts as a copy of the current one. Readers
+    /// keep using the previous version until they look up a
+    /// controller again. Updates are serialized.
+    ///
+    /// \param update  Function that modifies the new version, called with a Database&
+    ///
+    ///////////////////////////////////////////////////////////
+    template <typename Update>
+    static void updateDatabase(Update&& update);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Swap in a new version of the database
+    ///
+    /// Must be called with the update mutex locked.
+    ///
+    /// \param db  New version
+    ///
+    ///////////////////////////////////////////////////////////
+    static void publishDatabase(std::shared_ptr<const Database> db);
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Make a database key from a VID/PID pair
+    ///
+    /// \param vid  Vendor ID
+    /// \param pid  Product ID
+    ///
+    /// \return Key of the pair
+    ///
+    ///////////////////////////////////////////////////////////
+    static uint32_t makeKey(uint16_t vid, uint16_t pid)
+    {
+        return (static_cast<uint32_t>(vid) << 16) | pid;
+    }
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Make a database key from the VID/PID pair of a GUID
+    ///
+    /// \param guid  GUID
+    ///
+    /// \return Key of the pair
+    ///
+    ///////////////////////////////////////////////////////////
+    static uint32_t makeKey(const GamepadBackend::Guid& guid)
+    {
+        return makeKey(static_cast<uint16_t>(guid[4] | (guid[5] << 8)), static_cast<uint16_t>(guid[8] | (guid[9] << 8)));
+    }
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Clear the CRC of a GUID
+    ///
+    /// Most mappings have no CRC, they apply to any controller name.
+    ///
+    /// \param guid  GUID
+    ///
+    /// \return GUID without CRC
+    ///
+    ///////////////////////////////////////////////////////////
+    static GamepadBackend::Guid clearCrc(GamepadBackend::Guid guid)
+    {
+        guid[2] = guid[3] = 0;
+        return guid;
+    }
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Clear the CRC and the version of a GUID
+    ///
+    /// The remaining bus type, VID/PID and driver bytes identify a
+    /// product regardless of its revision.
+    ///
+    /// \param guid  GUID
+    ///
+    /// \return GUID without CRC and version
+    ///
+    ///////////////////////////////////////////////////////////
+    static GamepadBackend::Guid stripGuid(GamepadBackend::Guid guid)
+    {
+        guid = clearCrc(guid);
+        guid[12] = guid[13] = 0;
+        return guid;
+    }
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Encode a control description as a byte
+    ///
+    /// Bits 0-1 hold the type, bit 2 the direction, bits 3-7 the id.
+    ///
+    /// \param control  Control description to encode
+    ///
+    /// \return Encoded control
+    ///
+    ///////////////////////////////////////////////////////////
+    static uint8_t encodeControl(const ControlInfo& control)
+    {
+        return static_cast<uint8_t>(control.type | (control.dir << 2) | (control.id << 3));
+    }
+
+    ///////////////////////////////////////////////////////////
+    /// \brief Decode a control description encoded by encodeControl()
+    ///
+    /// \param code  Encoded control
+    ///
+    /// \return Control description
+    ///
+    ///////////////////////////////////////////////////////////
+    static ControlInfo decodeControl(uint8_t code)
+    {
+        ControlInfo control{0};
+        control.type = code & 0x03;
+        control.dir  = (code >> 2) & 0x01;
+        control.id   = code >> 3;
+        return control;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Header of a compiled database
+    ///
+    /// A compiled database is made of this header, followed by
+    /// entryCount BinaryEntry records and a block of namesSize bytes
+    /// holding the null-terminated controller names. All values are
+    /// little-endian.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct BinaryHeader
+    {
+        uint32_t magic;         //!< Must be BinaryMagic
+        uint16_t version;       //!< Must be BinaryVersion
+        uint8_t  platform;      //!< Platform of the mappings
+        uint8_t  controlCount;  //!< Must be Gamepad::ControlCount
+        uint32_t entryCount;    //!< Number of controllers
+        uint32_t namesSize;     //!< Size of the names block, in bytes
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Controller record of a compiled database
+    ///
+    ////////////////////////////////////////////////////////////
+    struct BinaryEntry
+    {
+        GamepadBackend::Guid guid;                              //!< GUID of the controller
+        uint32_t             name;                              //!< Offset of the name in the names block
+        uint8_t              controls[Gamepad::ControlCount];   //!< Controls encoded by encodeControl(), indexed by Gamepad::Control
+    };
+
+    static constexpr uint32_t BinaryMagic   = 0x4D474653; //!< "SFGM" read as a little-endian integer
+    static constexpr uint16_t BinaryVersion = 2;          //!< Current version of the compiled database format
+
+    static constexpr std::size_t MaxTokens = 64;                //!< Maximum number of fields on a database line
+    static constexpr std::size_t MinChunkSize = 256 * 1024;     //!< Minimum size of text parsed by a thread
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cached mapping resolution of a joystick slot
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Slot
+    {
+        std::shared_ptr<const Database> db;     //!< Database the infos belong to, kept alive while used
+        const Infos* infos = nullptr;           //!< Resolved controller infos, nullptr if unknown
+        bool         connected = false;         //!< Connection state when resolved
+        unsigned int connection = 0;            //!< Connection number of the controller when resolved
+        unsigned int vendorId = 0;              //!< Vendor ID of the controller when resolved
+        unsigned int productId = 0;             //!< Product ID of the controller when resolved
+        bool         identified = false;        //!< True if the GUID of the controller was known when resolved
+        GamepadBackend::Guid guid{};            //!< GUID of the controller when resolved
+        unsigned int generation = 0;            //!< Database generation when resolved
+        Infos        decoded;                   //!< Storage for infos decoded from the mapping table
+    };
 
-    static Vendors      _db;        //!< Full mapping
-    static unsigned int _lineCount; //!< Current line in the databse being parsed
+    static std::shared_ptr<const Database> _db;             //!< Current database, accessed through std::atomic_load/store
+    static std::atomic<unsigned int> _generation;           //!< Incremented each time the database changes
+    static std::mutex            _updateMutex;              //!< Serializes the database updates
+    static std::atomic<Platform> _platform;                 //!< Platform whose mappings are loaded
+    static std::atomic<bool>     _lazy;                     //!< True to parse the entries on first use
+    static thread_local std::deque<Slot> _slots;            //!< Cached resolutions, one per joystick slot and thread
+    static std::deque<std::string> _names;                  //!< Controller names, the first one is empty
+    static std::unordered_map<std::string_view, uint32_t> _nameIndex; //!< Indices of the names in _names
+    static std::mutex            _namesMutex;               //!< Protects the name pool
 };
 
 }
@@ -0,0 +1,594 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/EvdevGamepadBackend.hpp>
+#include <GamepadImpl.hpp>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+
+namespace sf
+{
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Axes a0 to a5 of the mappings, read through sf::Joystick::Axis,
+/// the next ones are read as extended axes
+////////////////////////////////////////////////////////////
+constexpr unsigned int MappedAxisCount = 6;
+constexpr unsigned int MaxAxes = MappedAxisCount + priv::GamepadImpl::ExtendedAxisCount;
+
+////////////////////////////////////////////////////////////
+/// Mapping axis of each sf::Joystick::Axis, the inverse of the
+/// a0 to a5 conversion of the mappings
+////////////////////////////////////////////////////////////
+constexpr unsigned int mappingAxes[] =
+{
+    0, // X
+    1, // Y
+    2, // Z
+    5, // R
+    3, // U
+    4  // V
+};
+
+constexpr std::size_t bitsSize(std::size_t bits)
+{
+    return (bits + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long));
+}
+
+bool testBit(const unsigned long* bits, unsigned int bit)
+{
+    return (bits[bit / (8 * sizeof(unsigned long))] >> (bit % (8 * sizeof(unsigned long)))) & 1ul;
+}
+
+////////////////////////////////////////////////////////////
+/// Convert an evdev axis value to [-100, 100]
+////////////////////////////////////////////////////////////
+float normalize(int value, const EvdevGamepadBackend::AxisInfo& axis)
+{
+    if (axis.maximum <= axis.minimum)
+        return 0.f;
+
+    const double range = static_cast<double>(axis.maximum) - axis.minimum;
+    const auto position = static_cast<float>((value - static_cast<double>(axis.minimum)) * 200.0 / range - 100.0);
+    return std::clamp(position, -100.f, 100.f);
+}
+
+////////////////////////////////////////////////////////////
+/// Query the description of an evdev device, with the buttons
+/// and axes in the order SDL gives them to the mappings
+////////////////////////////////////////////////////////////
+bool queryInfo(int fd, EvdevGamepadBackend::DeviceInfo& info)
+{
+    input_id id;
+    if (ioctl(fd, EVIOCGID, &id) < 0)
+        return false;
+
+    char name[256] = {};
+    ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+    info.identification.name = String::fromUtf8(name, name + std::strlen(name));
+    info.identification.vendorId = id.vendor;
+    info.identification.productId = id.product;
+    info.bus = id.bustype;
+    info.version = id.version;
+
+    unsigned long keyBits[bitsSize(KEY_CNT)] = {};
+    unsigned long absBits[bitsSize(ABS_CNT)] = {};
+    if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) < 0)
+        return false;
+
+    // Joystick buttons first, then the keys before them
+    info.buttons.clear();
+    for (unsigned int code = BTN_JOYSTICK; code < KEY_MAX; ++code)
+        if (testBit(keyBits, code))
+            info.buttons.push_back(code);
+    for (unsigned int code = 0; code < BTN_JOYSTICK; ++code)
+        if (testBit(keyBits, code))
+            info.buttons.push_back(code);
+
+    // The hats are not axes of the mappings
+    info.axes.clear();
+    for (unsigned int code = 0; code < ABS_MAX; ++code)
+    {
+        if (code >= ABS_HAT0X && code <= ABS_HAT3Y)
+            continue;
+
+        input_absinfo abs;
+        if (testBit(absBits, code) && ioctl(fd, EVIOCGABS(code), &abs) >= 0)
+            info.axes.push_back({code, abs.minimum, abs.maximum});
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////
+/// Make the SDL GUID of a device, from its IDs and the CRC-16
+/// of its name. Devices without IDs store their name instead.
+////////////////////////////////////////////////////////////
+GamepadBackend::Guid makeGuid(const EvdevGamepadBackend::DeviceInfo& info)
+{
+    const auto name = info.identification.name.toUtf8();
+    const auto store = [](GamepadBackend::Guid& guid, std::size_t offset, unsigned int value)
+    {
+        guid[offset] = static_cast<std::uint8_t>(value & 0xFF);
+        guid[offset + 1] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
+    };
+
+    std::uint16_t crc = 0;
+    for (const auto byte : name)
+    {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? static_cast<std::uint16_t>((crc >> 1) ^ 0xA001) : static_cast<std::uint16_t>(crc >> 1);
+    }
+
+    GamepadBackend::Guid guid{};
+    store(guid, 0, info.bus);
+    store(guid, 2, crc);
+
+    const auto& id = info.identification;
+    if (id.vendorId && id.productId)
+    {
+        store(guid, 4, id.vendorId);
+        store(guid, 8, id.productId);
+        store(guid, 12, info.version);
+    }
+    else
+    {
+        std::copy_n(name.begin(), std::min<std::size_t>(name.size(), guid.size() - 4), guid.begin() + 4);
+    }
+
+    return guid;
+}
+
+////////////////////////////////////////////////////////////
+/// Whether a device looks like a joystick : X and Y axes and
+/// joystick or gamepad buttons, which excludes the keyboards,
+/// mice and touchpads
+////////////////////////////////////////////////////////////
+bool isJoystick(const EvdevGamepadBackend::DeviceInfo& info)
+{
+    const auto hasAxis = [&info](unsigned int code)
+    {
+        return std::any_of(info.axes.begin(), info.axes.end(), [code](const auto& axis) { return axis.code == code; });
+    };
+    const auto hasButton = std::any_of(info.buttons.begin(), info.buttons.end(), [](unsigned int code)
+    {
+        return code >= BTN_JOYSTICK && code < BTN_DIGI;
+    });
+
+    return hasButton && hasAxis(ABS_X) && hasAxis(ABS_Y);
+}
+}
+
+
+////////////////////////////////////////////////////////////
+/// State of an attached device, updated by its events
+////////////////////////////////////////////////////////////
+struct EvdevGamepadBackend::Device
+{
+    Device()
+    {
+        buttonIndices.fill(-1);
+        axisIndices.fill(-1);
+    }
+
+    int                               fd = -1;            //!< Descriptor, -1 when the slot is free
+    unsigned int                      connection = 0;     //!< Connection number
+    std::string                       path;               //!< Path of the device, empty if not scanned
+    bool                              dropped = false;    //!< Events dropped, ignored until the next report
+    std::array<char, sizeof(input_event)> partial{};      //!< Start of a record cut by a short read
+    std::size_t                       partialSize = 0;    //!< Size of the start of the record in partial
+    Joystick::Identification          identification;     //!< Name, vendor and product IDs
+    Guid                              guid{};             //!< SDL GUID
+    std::array<std::int8_t, KEY_CNT>  buttonIndices;      //!< Button of each KEY code, -1 if none
+    std::array<std::int8_t, ABS_CNT>  axisIndices;        //!< Axis of each ABS code, -1 if none
+    AxisInfo                          ranges[MaxAxes];    //!< Range of each axis
+    std::uint32_t                     buttons = 0;        //!< Pressed buttons
+    float                             axes[MaxAxes] = {}; //!< Axis positions
+    float                             hat[2] = {};        //!< Hat position, as PovX and PovY
+};
+
+
+////////////////////////////////////////////////////////////
+EvdevGamepadBackend::EvdevGamepadBackend() :
+_epoll(epoll_create1(EPOLL_CLOEXEC))
+{
+    if (_epoll < 0)
+        std::cerr << "Failed to create the epoll instance of the evdev backend : " << std::strerror(errno) << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+EvdevGamepadBackend::~EvdevGamepadBackend()
+{
+    for (auto& device : _devices)
+        if (device.fd >= 0)
+            close(device.fd);
+
+    if (_epoll >= 0)
+        close(_epoll);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int EvdevGamepadBackend::scan(const std::string& directory)
+{
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return 0;
+
+    std::vector<std::string> names;
+    while (const dirent* entry = readdir(dir))
+        if (std::strncmp(entry->d_name, "event", 5) == 0)
+            names.emplace_back(entry->d_name);
+    closedir(dir);
+
+    // Numeric order, so that the slots follow the order the devices were plugged
+    std::sort(names.begin(), names.end(), [](const std::string& left, const std::string& right)
+    {
+        return left.size() != right.size() ? left.size() < right.size() : left < right;
+    });
+
+    unsigned int count = 0;
+    for (const auto& name : names)
+    {
+        const auto path = directory + '/' + name;
+        if (std::any_of(_devices.begin(), _devices.end(), [&path](const Device& device) { return device.path == path; }))
+            continue;
+
+        // Most event devices are not readable by the users, only the joysticks are
+        const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+
+        DeviceInfo info;
+        if (!queryInfo(fd, info) || !isJoystick(info))
+        {
+            close(fd);
+            continue;
+        }
+
+        if (add(fd, info, path))
+            ++count;
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::attach(int fd)
+{
+    DeviceInfo info;
+    if (!queryInfo(fd, info))
+    {
+        std::cerr << "Failed to attach a device to the evdev backend : not an evdev device" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    return add(fd, info, std::string());
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::attach(int fd, const DeviceInfo& info)
+{
+    return add(fd, info, std::string());
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::wait(Time timeout)
+{
+    epoll_event event;
+    int result;
+    do
+    {
+        result = epoll_wait(_epoll, &event, 1, std::max(timeout.asMilliseconds(), 0));
+    }
+    while (result < 0 && errno == EINTR);
+
+    return result > 0;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int EvdevGamepadBackend::getCount()
+{
+    return static_cast<unsigned int>(_devices.size());
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::update()
+{
+    constexpr int MaxEvents = 16;
+    epoll_event events[MaxEvents];
+    int count;
+
+    // Only the devices that sent events are read
+    do
+    {
+        count = epoll_wait(_epoll, events, MaxEvents, 0);
+        for (int i = 0; i < count; ++i)
+        {
+            auto& device = _devices[events[i].data.u32];
+            if (device.fd >= 0 && !readEvents(device))
+                detach(device);
+        }
+    }
+    while (count == MaxEvents);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::isConnected(unsigned int joystick)
+{
+    return joystick < _devices.size() && _devices[joystick].fd >= 0;
+}
+
+
+////////////////////////////////////////////////////////////
+Joystick::Identification EvdevGamepadBackend::getIdentification(unsigned int joystick)
+{
+    return joystick < _devices.size() ? _devices[joystick].identification : Joystick::Identification();
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::isButtonPressed(unsigned int joystick, unsigned int button)
+{
+    return joystick < _devices.size() && button < Joystick::ButtonCount && ((_devices[joystick].buttons >> button) & 1u);
+}
+
+
+////////////////////////////////////////////////////////////
+float EvdevGamepadBackend::getAxisPosition(unsigned int joystick, Joystick::Axis axis)
+{
+    if (joystick >= _devices.size())
+        return 0.f;
+
+    const auto& device = _devices[joystick];
+    switch (axis)
+    {
+        case Joystick::PovX: return device.hat[0];
+        case Joystick::PovY: return device.hat[1];
+        default:             return device.axes[mappingAxes[axis]];
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+float EvdevGamepadBackend::getExtendedAxisPosition(unsigned int joystick, unsigned int axis)
+{
+    if (joystick >= _devices.size() || axis >= priv::GamepadImpl::ExtendedAxisCount)
+        return 0.f;
+
+    return _devices[joystick].axes[MappedAxisCount + axis];
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::getGuid(unsigned int joystick, Guid& guid)
+{
+    if (!isConnected(joystick))
+        return false;
+
+    guid = _devices[joystick].guid;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::getConnection(unsigned int joystick, unsigned int& connection)
+{
+    if (!isConnected(joystick))
+        return false;
+
+    connection = _devices[joystick].connection;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::add(int fd, const DeviceInfo& info, const std::string& path)
+{
+    const int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0)
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    auto slot = std::find_if(_devices.begin(), _devices.end(), [](const Device& device) { return device.fd < 0; });
+    if (slot == _devices.end())
+        slot = _devices.emplace(_devices.end());
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = static_cast<std::uint32_t>(slot - _devices.begin());
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        std::cerr << "Failed to attach a device to the evdev backend : " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    auto& device = *slot;
+    device = Device();
+    // A new connection number tells the slot cache that the slot may have been used by another device
+    device.fd = fd;
+    device.connection = ++_connections;
+    device.path = path;
+    device.identification = info.identification;
+    device.guid = makeGuid(info);
+
+    const auto buttonCount = std::min<std::size_t>(info.buttons.size(), Joystick::ButtonCount);
+    for (std::size_t i = 0; i < buttonCount; ++i)
+        if (info.buttons[i] < KEY_CNT)
+            device.buttonIndices[info.buttons[i]] = static_cast<std::int8_t>(i);
+
+    // Streams start at rest, devices are queried below
+    const auto axisCount = std::min<std::size_t>(info.axes.size(), MaxAxes);
+    for (std::size_t i = 0; i < axisCount; ++i)
+    {
+        if (info.axes[i].code >= ABS_CNT)
+            continue;
+
+        device.axisIndices[info.axes[i].code] = static_cast<std::int8_t>(i);
+        device.ranges[i] = info.axes[i];
+        device.axes[i] = normalize(0, info.axes[i]);
+    }
+
+    resync(device);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void EvdevGamepadBackend::detach(Device& device)
+{
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, device.fd, nullptr);
+    close(device.fd);
+    device = Device();
+}
+
+
+////////////////////////////////////////////////////////////
+bool EvdevGamepadBackend::readEvents(Device& device)
+{
+    // Pipes and sockets may cut a record : its start is kept and read again with the rest
+    char buffer[64 * sizeof(input_event)];
+    for (;;)
+    {
+        std::memcpy(buffer, device.partial.data(), device.partialSize);
+        const auto size = read(device.fd, buffer + device.partialSize, sizeof(buffer) - device.partialSize);
+        if (size == 0)
+            return false;
+
+        if (size < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // ENODEV when the device is unplugged
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        const auto available = device.partialSize + static_cast<std::size_t>(size);
+        const auto count = available / sizeof(input_event);
+        device.partialSize = available % sizeof(input_event);
+        std::memcpy(device.partial.data(), buffer + count * sizeof(input_event), device.partialSize);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            input_event event;
+            std::memcpy(&event, buffer + i * sizeof(input_event), sizeof(event));
+            if (event.type == EV_SYN)
+            {
+                if (event.code == SYN_DROPPED)
+                {
+                    device.dropped = true;
+                }
+                else if (event.code == SYN_REPORT && device.dropped)
+                {
+                    device.dropped = false;
+                    resync(device);
+                }
+            }
+            else if (device.dropped)
+            {
+                // The state is queried at the end of the report
+            }
+            else if (event.type == EV_KEY && event.code < KEY_CNT)
+            {
+                const auto index = device.buttonIndices[event.code];
+                if (index >= 0 && event.value)
+                    device.buttons |= 1u << index;
+                else if (index >= 0)
+                    device.buttons &= ~(1u << index);
+            }
+            else if (event.type == EV_ABS && (event.code == ABS_HAT0X || event.code == ABS_HAT0Y))
+            {
+                device.hat[event.code - ABS_HAT0X] = std::clamp(event.value, -1, 1) * 100.f;
+            }
+            else if (event.type == EV_ABS && event.code < ABS_CNT)
+            {
+                const auto index = device.axisIndices[event.code];
+                if (index >= 0)
+                    device.axes[index] = normalize(event.value, device.ranges[index]);
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void EvdevGamepadBackend::resync(Device& device)
+{
+    // Fails on streams, which have no state to query
+    unsigned long keyBits[bitsSize(KEY_CNT)] = {};
+    if (ioctl(device.fd, EVIOCGKEY(sizeof(keyBits)), keyBits) < 0)
+        return;
+
+    device.buttons = 0;
+    for (unsigned int code = 0; code < KEY_CNT; ++code)
+        if (device.buttonIndices[code] >= 0 && testBit(keyBits, code))
+            device.buttons |= 1u << device.buttonIndices[code];
+
+    for (unsigned int code = 0; code < ABS_CNT; ++code)
+    {
+        input_absinfo abs;
+        const auto index = device.axisIndices[code];
+        if (index >= 0 && ioctl(device.fd, EVIOCGABS(code), &abs) >= 0)
+            device.axes[index] = normalize(abs.value, device.ranges[index]);
+    }
+
+    for (unsigned int code = ABS_HAT0X; code <= ABS_HAT0Y; ++code)
+    {
+        input_absinfo abs;
+        if (ioctl(device.fd, EVIOCGABS(code), &abs) >= 0)
+            device.hat[code - ABS_HAT0X] = std::clamp(abs.value, -1, 1) * 100.f;
+    }
+}
+
+}
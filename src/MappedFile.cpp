@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <MappedFile.hpp>
+
+#include <SFML/Config.hpp>
+
+#if defined(SFML_SYSTEM_LINUX) || defined(SFML_SYSTEM_FREEBSD) || \
+    defined(SFML_SYSTEM_MACOS) || defined(SFML_SYSTEM_ANDROID)
+    #define SFML_GAMEPAD_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <fstream>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+priv::MappedFile::~MappedFile()
+{
+    close();
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::MappedFile::open(const std::string& filename, bool map)
+{
+    close();
+
+    if (!map)
+        return read(filename);
+
+#ifdef SFML_GAMEPAD_MMAP
+    const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat status;
+    if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+        void* data = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            // The file is read once from start to end
+            ::madvise(data, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+
+            _data = static_cast<const char*>(data);
+            _size = static_cast<std::size_t>(status.st_size);
+            ::close(fd);
+            return true;
+        }
+    }
+
+    // Empty files, pipes and file systems without mapping support are read
+    ::close(fd);
+#endif
+
+    return read(filename);
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::MappedFile::close()
+{
+#ifdef SFML_GAMEPAD_MMAP
+    if (_data)
+        ::munmap(const_cast<char*>(_data), _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+}
+
+
+////////////////////////////////////////////////////////////
+std::string_view priv::MappedFile::getContent() const
+{
+    return _data ? std::string_view(_data, _size) : std::string_view(_buffer);
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::MappedFile::read(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    // Block reads, the size of the file is not known for pipes
+    char block[64 * 1024];
+    while (file.read(block, sizeof(block)) || file.gcount() > 0)
+        _buffer.append(block, static_cast<std::size_t>(file.gcount()));
+
+    return !file.bad();
+}
+
+}
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Read-only view of the content of a file
+///
+/// The file is mapped in memory where the system supports it,
+/// otherwise it is read into a buffer.
+///
+/// A mapped file that is truncated while it is read raises
+/// SIGBUS : the files that may be rewritten while in use, such
+/// as the watched ones, must be read into a buffer.
+///
+////////////////////////////////////////////////////////////
+class MappedFile
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor, no file is opened
+    ///
+    ////////////////////////////////////////////////////////////
+    MappedFile() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor, closes the file
+    ///
+    ////////////////////////////////////////////////////////////
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a file, closing the previous one
+    ///
+    /// \param filename  Path of the file to open
+    /// \param map       False to read the file into a buffer instead of mapping it
+    ///
+    /// \return True if the file has been opened, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool open(const std::string& filename, bool map = true);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Close the file
+    ///
+    ////////////////////////////////////////////////////////////
+    void close();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the content of the file
+    ///
+    /// The view is valid until the file is closed.
+    ///
+    /// \return Content of the file, empty if no file is opened
+    ///
+    ////////////////////////////////////////////////////////////
+    std::string_view getContent() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Read a file into the fallback buffer
+    ///
+    /// \param filename  Path of the file to read
+    ///
+    /// \return True if the file has been read, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool read(const std::string& filename);
+
+    const char* _data = nullptr;    //!< Mapped pages, nullptr if the file is not mapped
+    std::size_t _size = 0;          //!< Size of the mapped pages
+    std::string _buffer;            //!< Content of the file when it could not be mapped
+};
+
+}
+}
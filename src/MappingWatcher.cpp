@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <MappingWatcher.hpp>
+#include <GamepadImpl.hpp>
+
+#include <SFML/Config.hpp>
+
+#ifdef SFML_SYSTEM_LINUX
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <system_error>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+std::thread priv::MappingWatcher::_thread;
+std::atomic<bool> priv::MappingWatcher::_running{false};
+
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Stops the watching thread before the static members are
+/// destroyed : a joinable std::thread must not be destroyed
+////////////////////////////////////////////////////////////
+struct WatcherGuard
+{
+    ~WatcherGuard()
+    {
+        priv::MappingWatcher::stop();
+    }
+} watcherGuard;
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::MappingWatcher::start()
+{
+    stop();
+
+#ifdef SFML_SYSTEM_LINUX
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cerr << "Could not watch the mapping files" << std::endl;
+        return false;
+    }
+
+    _running = true;
+    try
+    {
+        _thread = std::thread(run, fd);
+    }
+    catch (const std::system_error&)
+    {
+        _running = false;
+        close(fd);
+        return false;
+    }
+
+    return true;
+#else
+    std::cerr << "Watching the mapping files is only supported on Linux" << std::endl;
+    return false;
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::MappingWatcher::stop()
+{
+    _running = false;
+    if (_thread.joinable())
+        _thread.join();
+}
+
+
+#ifdef SFML_SYSTEM_LINUX
+
+////////////////////////////////////////////////////////////
+void priv::MappingWatcher::run(int fd)
+{
+    std::vector<std::string> directories;
+    std::vector<std::string> files;
+    alignas(inotify_event) char buffer[4096];
+
+    bool pending = false;
+    auto lastChange = std::chrono::steady_clock::now();
+
+    while (_running)
+    {
+        // Files loaded since the last iteration are watched as well
+        updateWatches(fd, directories, files);
+
+        // The timeout lets the thread see when it is stopped
+        pollfd request{fd, POLLIN, 0};
+        if (poll(&request, 1, QuietDelay) > 0)
+        {
+            ssize_t size;
+            while ((size = read(fd, buffer, sizeof(buffer))) > 0)
+            {
+                for (ssize_t offset = 0; offset < size;)
+                {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                    // Only the names are compared : a file of another watched directory
+                    // may trigger a reload check, which then finds nothing changed
+                    if ((event->mask & IN_Q_OVERFLOW) ||
+                        (event->len > 0 && std::find(files.begin(), files.end(), event->name) != files.end()))
+                    {
+                        pending = true;
+                        lastChange = std::chrono::steady_clock::now();
+                    }
+                }
+            }
+        }
+
+        // Editors often write a file in several steps : wait for them to be done
+        if (pending && std::chrono::steady_clock::now() - lastChange >= std::chrono::milliseconds(QuietDelay))
+        {
+            pending = false;
+            GamepadImpl::reloadMappingFiles();
+        }
+    }
+
+    close(fd);
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::MappingWatcher::updateWatches(int fd, std::vector<std::string>& directories, std::vector<std::string>& files)
+{
+    GamepadImpl::getMappingFiles(files);
+
+    for (auto& file : files)
+    {
+        const auto separator = file.find_last_of('/');
+        std::string directory = ".";
+        if (separator == 0)
+            directory = "/";
+        else if (separator != std::string::npos)
+            directory = file.substr(0, separator);
+
+        if (separator != std::string::npos)
+            file.erase(0, separator + 1);
+
+        if (std::find(directories.begin(), directories.end(), directory) != directories.end())
+            continue;
+
+        // Saved files are either written in place or renamed over the previous one
+        if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+            std::cerr << "Could not watch '" << directory << "'" << std::endl;
+
+        directories.push_back(directory);
+    }
+}
+
+#endif
+
+}
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Background thread that reloads the mapping files when they change
+///
+/// The directories of the loaded files are watched with inotify,
+/// so that files replaced by a rename are seen as well. Events
+/// are coalesced: the files are reloaded once they stayed quiet
+/// for a short delay.
+///
+////////////////////////////////////////////////////////////
+class MappingWatcher
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Start the watching thread, restarting it if already running
+    ///
+    /// \return True if the thread has been started, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool start();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the watching thread and wait for it
+    ///
+    ////////////////////////////////////////////////////////////
+    static void stop();
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Body of the watching thread
+    ///
+    /// \param fd  inotify instance, closed when the thread ends
+    ///
+    ////////////////////////////////////////////////////////////
+    static void run(int fd);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Watch the directories of the loaded files
+    ///
+    /// \param fd           inotify instance
+    /// \param directories  Directories already watched, updated
+    /// \param files        Receives the names of the loaded files, without their directory
+    ///
+    ////////////////////////////////////////////////////////////
+    static void updateWatches(int fd, std::vector<std::string>& directories, std::vector<std::string>& files);
+
+    static constexpr int QuietDelay = 100; //!< Milliseconds without events before reloading
+
+    static std::thread       _thread;   //!< Watching thread
+    static std::atomic<bool> _running;  //!< False to stop the watching thread
+};
+
+}
+}
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <Recorder.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+
+namespace sf
+{
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Zigzag-encode a signed value, so that small differences
+/// of both signs make short varints
+////////////////////////////////////////////////////////////
+std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Recorder::open(const std::string& filename, unsigned int count)
+{
+    static_assert(sizeof(RecordingHeader) == 12, "Unexpected recording header layout");
+
+    close();
+
+    _file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!_file.is_open())
+    {
+        std::cerr << "Could not create '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    RecordingHeader header;
+    header.magic         = Magic;
+    header.version       = Version;
+    header.joystickCount = static_cast<std::uint16_t>(std::min(count, 0xFFFFu));
+    header.buttonCount   = Joystick::ButtonCount;
+    header.axisCount     = AxisCount;
+    header.reserved      = 0;
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    _states.assign(count, JoystickState());
+
+    _clock.restart();
+    _time = 0;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::Recorder::close()
+{
+    if (_file.is_open())
+        _file.close();
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Recorder::isOpen() const
+{
+    return _file.is_open();
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::Recorder::capture(GamepadBackend& backend)
+{
+    const std::int64_t time = _clock.getElapsedTime().asMicroseconds();
+
+    _frame.clear();
+    writeVarint(static_cast<std::uint64_t>(time - _time));
+    _time = time;
+
+    // Slots added since the previous frame start disconnected
+    const auto count = backend.getCount();
+    if (_states.size() < count)
+        _states.resize(count);
+
+    for (unsigned int joystick = 0; joystick < _states.size(); joystick++)
+    {
+        auto& previous = _states[joystick];
+        JoystickState state;
+        state.connected = joystick < count && backend.isConnected(joystick);
+
+        if (state.connected)
+        {
+            for (unsigned int button = 0; button < Joystick::ButtonCount; button++)
+                state.buttons |= static_cast<std::uint32_t>(backend.isButtonPressed(joystick, button)) << button;
+
+            for (unsigned int axis = 0; axis < AxisCount; axis++)
+            {
+                const auto position = axis < Joystick::AxisCount ?
+                    backend.getAxisPosition(joystick, static_cast<Joystick::Axis>(axis)) :
+                    backend.getExtendedAxisPosition(joystick, axis - Joystick::AxisCount);
+                state.axes[axis] = static_cast<std::int32_t>(std::lround(position * Scale));
+            }
+        }
+
+        std::uint8_t changes = 0;
+        if (state.connected != previous.connected)
+        {
+            changes |= state.connected ? Connected : Disconnected;
+            previous = JoystickState();
+        }
+
+        static_assert(AxisCount <= 32, "The moved axes must fit in a 32-bit mask");
+        std::uint32_t movedAxes = 0;
+        for (unsigned int axis = 0; axis < AxisCount; axis++)
+        {
+            if (state.axes[axis] != previous.axes[axis])
+                movedAxes |= 1u << axis;
+        }
+
+        if (state.buttons != previous.buttons)
+            changes |= Buttons;
+        if (movedAxes)
+            changes |= Axes;
+
+        if (!changes)
+            continue;
+
+        writeVarint(joystick + 1);
+        _frame.push_back(static_cast<char>(changes));
+
+        if (changes & Connected)
+        {
+            const auto id = backend.getIdentification(joystick);
+            const auto name = id.name.toUtf8();
+            writeVarint(id.vendorId);
+            writeVarint(id.productId);
+            writeVarint(name.size());
+            _frame.append(name.begin(), name.end());
+
+            GamepadBackend::Guid guid;
+            const bool identified = backend.getGuid(joystick, guid);
+            _frame.push_back(static_cast<char>(identified));
+            if (identified)
+                _frame.append(guid.begin(), guid.end());
+        }
+
+        if (changes & Buttons)
+            writeVarint(state.buttons ^ previous.buttons);
+
+        if (changes & Axes)
+        {
+            writeVarint(movedAxes);
+            for (unsigned int axis = 0; axis < AxisCount; axis++)
+            {
+                if (movedAxes & (1u << axis))
+                    writeVarint(zigzag(static_cast<std::int64_t>(state.axes[axis]) - previous.axes[axis]));
+            }
+        }
+
+        previous = state;
+    }
+
+    _frame.push_back(0);
+    _file.write(_frame.data(), static_cast<std::streamsize>(_frame.size()));
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::Recorder::writeVarint(std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        _frame.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    _frame.push_back(static_cast<char>(value));
+}
+
+}
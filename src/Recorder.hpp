@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/GamepadBackend.hpp>
+#include <GamepadImpl.hpp>
+
+#include <SFML/System/Clock.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Records the raw joystick states read from a backend
+///
+/// A recording is made of a RecordingHeader followed by one frame
+/// per capture. A frame holds the time elapsed since the previous
+/// one, in microseconds, then a record for each joystick whose
+/// state changed, then a zero byte. A record holds the index of
+/// the joystick plus one, the Change flags and, in this order:
+///
+/// - Connected: the vendor ID, the product ID, the length of the
+///   name, the UTF-8 name, then a byte set to 1 followed by the 16
+///   bytes of the GUID if the GUID is known, or set to 0
+/// - Buttons: the button mask, XORed with the previous one
+/// - Axes: a mask with a bit per changed axis, the sf::Joystick
+///   axes then the extended ones, then the signed difference with
+///   the previous position of each of them
+///
+/// Numbers are stored as LEB128 varints, signed ones zigzag-encoded.
+/// Positions are stored in hundredths.
+///
+////////////////////////////////////////////////////////////
+class Recorder
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Changes of a joystick in a frame
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Change : std::uint8_t
+    {
+        Connected    = 1 << 0, //!< The joystick has been connected
+        Disconnected = 1 << 1, //!< The joystick has been disconnected, its state is reset
+        Buttons      = 1 << 2, //!< Some buttons have been pressed or released
+        Axes         = 1 << 3  //!< Some axes have moved
+    };
+
+    static constexpr unsigned int AxisCount = Joystick::AxisCount + GamepadImpl::ExtendedAxisCount; //!< Recorded axes per joystick
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Raw state of a joystick, as stored in a recording
+    ///
+    ////////////////////////////////////////////////////////////
+    struct JoystickState
+    {
+        bool          connected = false;    //!< Connection state
+        std::uint32_t buttons = 0;          //!< Pressed buttons, a bit per button
+        std::int32_t  axes[AxisCount] = {}; //!< Axis positions then extended axis positions, in hundredths
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Header of a recording
+    ///
+    ////////////////////////////////////////////////////////////
+    struct RecordingHeader
+    {
+        std::uint32_t magic;            //!< Must be Magic
+        std::uint16_t version;          //!< Must be Version
+        std::uint16_t joystickCount;    //!< Number of joystick slots when the recording started
+        std::uint8_t  buttonCount;      //!< Number of buttons per joystick
+        std::uint8_t  axisCount;        //!< Number of axes per joystick
+        std::uint16_t reserved;         //!< Must be 0
+    };
+
+    static constexpr std::uint32_t Magic   = 0x52474653; //!< "SFGR" read as a little-endian integer
+    static constexpr std::uint16_t Version = 2;          //!< Current version of the recording format, 2 added the GUIDs and the extended axes
+    static constexpr float         Scale   = 100.f;      //!< Stored units per position unit
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a recording, closing the current one
+    ///
+    /// \param filename  Path of the file to write
+    /// \param count     Number of joystick slots of the backend
+    ///
+    /// \return True if the file has been created, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool open(const std::string& filename, unsigned int count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the recording
+    ///
+    ////////////////////////////////////////////////////////////
+    void close();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if a recording is in progress
+    ///
+    /// \return True if recording, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isOpen() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the current states of the joysticks as a frame
+    ///
+    /// \param backend  Backend to read
+    ///
+    ////////////////////////////////////////////////////////////
+    void capture(GamepadBackend& backend);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Append an unsigned varint to the current frame
+    ///
+    /// \param value  Value to append
+    ///
+    ////////////////////////////////////////////////////////////
+    void writeVarint(std::uint64_t value);
+
+    std::ofstream _file;                            //!< Recording file
+    std::string   _frame;                           //!< Frame being encoded
+    std::vector<JoystickState> _states;             //!< States recorded so far, one per slot
+    Clock         _clock;                           //!< Time since the start of the recording
+    std::int64_t  _time = 0;                        //!< Time of the last frame, in microseconds
+};
+
+}
+}
@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <Replay.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+
+namespace sf
+{
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Decode a zigzag-encoded signed value
+////////////////////////////////////////////////////////////
+std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::open(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not load '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    Recorder::RecordingHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != Recorder::Magic)
+    {
+        std::cerr << "'" << filename << "' is not an input recording" << std::endl;
+        return false;
+    }
+
+    // Older recordings have neither the GUIDs nor the extended axes
+    if (header.version < Recorder::Version)
+    {
+        std::cerr << "'" << filename << "' was recorded with an older format (" << header.version
+                  << "), which is no longer supported" << std::endl;
+        return false;
+    }
+
+    if (header.version != Recorder::Version || header.buttonCount != Joystick::ButtonCount ||
+        header.axisCount != Recorder::AxisCount)
+    {
+        std::cerr << "'" << filename << "' has an unsupported version (" << header.version << ")" << std::endl;
+        return false;
+    }
+
+    _data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    _position = 0;
+    _filename = filename;
+
+    _states.assign(header.joystickCount, Recorder::JoystickState());
+    _identities.assign(header.joystickCount, Identity());
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::update()
+{
+    if (_position >= _data.size())
+        return false;
+
+    if (!readFrame())
+    {
+        std::cerr << "'" << _filename << "' is corrupted" << std::endl;
+        _position = _data.size();
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int priv::Replay::getCount()
+{
+    return static_cast<unsigned int>(_states.size());
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::isConnected(unsigned int joystick)
+{
+    return _states[joystick].connected;
+}
+
+
+////////////////////////////////////////////////////////////
+Joystick::Identification priv::Replay::getIdentification(unsigned int joystick)
+{
+    return _identities[joystick].identification;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::isButtonPressed(unsigned int joystick, unsigned int button)
+{
+    return button < Joystick::ButtonCount && ((_states[joystick].buttons >> button) & 1u);
+}
+
+
+////////////////////////////////////////////////////////////
+float priv::Replay::getAxisPosition(unsigned int joystick, Joystick::Axis axis)
+{
+    return static_cast<float>(_states[joystick].axes[axis]) / Recorder::Scale;
+}
+
+
+////////////////////////////////////////////////////////////
+float priv::Replay::getExtendedAxisPosition(unsigned int joystick, unsigned int axis)
+{
+    if (axis >= Recorder::AxisCount - Joystick::AxisCount)
+        return 0.f;
+
+    return static_cast<float>(_states[joystick].axes[Joystick::AxisCount + axis]) / Recorder::Scale;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::getGuid(unsigned int joystick, Guid& guid)
+{
+    const auto& identity = _identities[joystick];
+    if (!identity.identified)
+        return false;
+
+    guid = identity.guid;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::getConnection(unsigned int joystick, unsigned int& connection)
+{
+    connection = _identities[joystick].connection;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::readFrame()
+{
+    // The time elapsed since the previous frame is not used to pace the replay
+    std::uint64_t elapsed;
+    if (!readVarint(elapsed))
+        return false;
+
+    for (;;)
+    {
+        std::uint64_t joystick;
+        if (!readVarint(joystick))
+            return false;
+
+        if (joystick == 0)
+            return true;
+        if (--joystick >= MaxJoysticks || _position >= _data.size())
+            return false;
+
+        // Slots added while recording
+        if (joystick >= _states.size())
+        {
+            _states.resize(joystick + 1);
+            _identities.resize(joystick + 1);
+        }
+
+        auto& state = _states[joystick];
+        const auto changes = static_cast<std::uint8_t>(_data[_position++]);
+
+        if (changes & (Recorder::Connected | Recorder::Disconnected))
+        {
+            state = Recorder::JoystickState();
+            state.connected = (changes & Recorder::Connected) != 0;
+            _identities[joystick] = Identity();
+            _identities[joystick].connection = ++_connectionCount;
+        }
+
+        if (changes & Recorder::Connected)
+        {
+            std::uint64_t vendorId, productId, length;
+            if (!readVarint(vendorId) || !readVarint(productId) || !readVarint(length) ||
+                length > _data.size() - _position)
+                return false;
+
+            auto& identity = _identities[joystick];
+            auto& id = identity.identification;
+            id.vendorId = static_cast<unsigned int>(vendorId);
+            id.productId = static_cast<unsigned int>(productId);
+            id.name = String::fromUtf8(_data.begin() + _position, _data.begin() + _position + length);
+            _position += length;
+
+            if (_position >= _data.size())
+                return false;
+
+            identity.identified = _data[_position++] != 0;
+            if (identity.identified)
+            {
+                if (identity.guid.size() > _data.size() - _position)
+                    return false;
+
+                std::copy_n(_data.begin() + static_cast<std::ptrdiff_t>(_position), identity.guid.size(), identity.guid.begin());
+                _position += identity.guid.size();
+            }
+        }
+
+        if (changes & Recorder::Buttons)
+        {
+            std::uint64_t toggled;
+            if (!readVarint(toggled))
+                return false;
+
+            state.buttons ^= static_cast<std::uint32_t>(toggled);
+        }
+
+        if (changes & Recorder::Axes)
+        {
+            std::uint64_t movedAxes;
+            if (!readVarint(movedAxes))
+                return false;
+
+            for (unsigned int axis = 0; axis < Recorder::AxisCount; axis++)
+            {
+                std::uint64_t delta;
+                if ((movedAxes & (1u << axis)) == 0)
+                    continue;
+                if (!readVarint(delta))
+                    return false;
+
+                state.axes[axis] += static_cast<std::int32_t>(unzigzag(delta));
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Replay::readVarint(std::uint64_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 64 && _position < _data.size(); shift += 7)
+    {
+        const auto byte = static_cast<std::uint8_t>(_data[_position++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+}
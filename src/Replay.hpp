@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <Recorder.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Backend that plays a recording made by Recorder
+///
+/// Each update plays the next frame, so that the states seen by
+/// the mapping layer are the same as when recording, frame by
+/// frame. The recorded times are ignored: frames are played as
+/// fast as they are requested.
+///
+////////////////////////////////////////////////////////////
+class Replay : public GamepadBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a recording
+    ///
+    /// All the joysticks are disconnected until the first update.
+    ///
+    /// \param filename  Path of the recording
+    ///
+    /// \return True if the recording has been loaded, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool open(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play the next frame
+    ///
+    /// \return False if the recording has ended, true otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update() override;
+
+    unsigned int getCount() override;
+    bool isConnected(unsigned int joystick) override;
+    Joystick::Identification getIdentification(unsigned int joystick) override;
+    bool isButtonPressed(unsigned int joystick, unsigned int button) override;
+    float getAxisPosition(unsigned int joystick, Joystick::Axis axis) override;
+    float getExtendedAxisPosition(unsigned int joystick, unsigned int axis) override;
+    bool getGuid(unsigned int joystick, Guid& guid) override;
+    bool getConnection(unsigned int joystick, unsigned int& connection) override;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Identity of a recorded joystick
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Identity
+    {
+        Joystick::Identification identification;       //!< Name, vendor and product IDs
+        bool                     identified = false;    //!< True if the GUID was recorded
+        Guid                     guid{};                //!< SDL GUID
+        unsigned int             connection = 0;        //!< Connection number
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the next frame of the recording
+    ///
+    /// \return True if the frame is valid, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool readFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read an unsigned varint
+    ///
+    /// \param value  Receives the value
+    ///
+    /// \return True if the value has been read, false if the data ends
+    ///
+    ////////////////////////////////////////////////////////////
+    bool readVarint(std::uint64_t& value);
+
+    static constexpr std::uint64_t MaxJoysticks = 1 << 20; //!< Highest number of slots accepted in a recording
+
+    std::string                           _filename;            //!< Path of the recording, for error messages
+    std::vector<char>                     _data;                //!< Content of the recording
+    std::size_t                           _position = 0;        //!< Offset of the next frame in _data
+    std::vector<Recorder::JoystickState>  _states;              //!< Current states, one per slot
+    std::vector<Identity>                 _identities;          //!< Identities of the connected joysticks, one per slot
+    unsigned int                          _connectionCount = 0; //!< Number of joysticks connected so far
+};
+
+}
+}
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <Sampler.hpp>
+
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+std::thread priv::Sampler::_thread;
+std::atomic<bool> priv::Sampler::_running{false};
+priv::SpscRing<Gamepad::Sample, priv::Sampler::RingSize> priv::Sampler::_ring;
+
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Stops the sampling thread before the static members are
+/// destroyed : a joinable std::thread must not be destroyed
+////////////////////////////////////////////////////////////
+struct SamplerGuard
+{
+    ~SamplerGuard()
+    {
+        priv::Sampler::stop();
+    }
+} samplerGuard;
+
+////////////////////////////////////////////////////////////
+/// Check if two captures of a gamepad are identical
+////////////////////////////////////////////////////////////
+bool isSameState(const Gamepad::State& lhs, const Gamepad::State& rhs)
+{
+    return lhs.available == rhs.available && lhs.pressed == rhs.pressed
+        && std::memcmp(lhs.positions, rhs.positions, sizeof(lhs.positions)) == 0;
+}
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Sampler::start(unsigned int frequency, unsigned int deadzone)
+{
+    stop();
+
+    if (frequency == 0)
+        return false;
+
+    _running = true;
+    try
+    {
+        _thread = std::thread(run, std::chrono::nanoseconds(1000000000 / frequency), deadzone);
+    }
+    catch (const std::system_error&)
+    {
+        _running = false;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::Sampler::stop()
+{
+    _running = false;
+    if (_thread.joinable())
+        _thread.join();
+}
+
+
+////////////////////////////////////////////////////////////
+bool priv::Sampler::poll(Gamepad::Sample& sample)
+{
+    return _ring.pop(sample);
+}
+
+
+////////////////////////////////////////////////////////////
+void priv::Sampler::run(std::chrono::nanoseconds period, unsigned int deadzone)
+{
+    // Last state pushed for each gamepad, samples are only pushed on change
+    std::vector<Gamepad::State> pushed;
+    std::vector<Gamepad::State> states;
+
+    // Controls pressed since the last push of each gamepad, while the ring was full
+    std::vector<std::uint32_t> latched;
+    Clock clock;
+
+    auto next = std::chrono::steady_clock::now();
+    while (_running)
+    {
+        // The number of slots changes with the backend
+        Gamepad::update();
+        Gamepad::captureAll(states, deadzone);
+        pushed.resize(states.size());
+        latched.resize(states.size());
+
+        Gamepad::Sample sample;
+        sample.timestamp = clock.getElapsedTime();
+
+        for (unsigned int gamepad = 0; gamepad < states.size(); gamepad++)
+        {
+            sample.gamepad = gamepad;
+            sample.state = states[gamepad];
+
+            // A press made and released while the ring was full is still pushed,
+            // its release follows on the next capture
+            if (sample.state.available)
+                sample.state.pressed |= latched[gamepad];
+            if (isSameState(sample.state, pushed[gamepad]))
+                continue;
+
+            if (_ring.push(sample))
+            {
+                pushed[gamepad] = sample.state;
+                latched[gamepad] = 0;
+            }
+            else
+            {
+                latched[gamepad] = sample.state.pressed;
+            }
+        }
+
+        // Captures are paced on absolute times, so that the rate does not drift,
+        // the missed ones are skipped when late
+        next = std::max(next + period, std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(next);
+    }
+}
+
+}
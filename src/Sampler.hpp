@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SpscRing.hpp>
+#include <SFMLGamepad/Gamepad.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Background thread that captures the gamepads at a fixed rate
+///
+////////////////////////////////////////////////////////////
+class Sampler
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Start the sampling thread, restarting it if already running
+    ///
+    /// \param frequency  Number of captures per second
+    /// \param deadzone   Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    /// \return True if the thread has been started, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool start(unsigned int frequency, unsigned int deadzone);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the sampling thread and wait for it
+    ///
+    ////////////////////////////////////////////////////////////
+    static void stop();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop the oldest sample
+    ///
+    /// \param sample  Receives the sample
+    ///
+    /// \return True if a sample was returned, false if there is none
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool poll(Gamepad::Sample& sample);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Body of the sampling thread
+    ///
+    /// \param period    Time between two captures
+    /// \param deadzone  Threshold value [0 .. 100] for axis to boolean conversion
+    ///
+    ////////////////////////////////////////////////////////////
+    static void run(std::chrono::nanoseconds period, unsigned int deadzone);
+
+    static constexpr std::size_t RingSize = 1024; //!< Maximum number of samples waiting to be polled
+
+    static std::thread                           _thread;   //!< Sampling thread
+    static std::atomic<bool>                     _running;  //!< False to stop the sampling thread
+    static SpscRing<Gamepad::Sample, RingSize>   _ring;     //!< Samples, from the sampling thread to the poller
+};
+
+}
+}
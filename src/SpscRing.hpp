@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <atomic>
+#include <cstddef>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Lock-free ring buffer for one producer and one consumer thread
+///
+/// push() must only be called by the producer thread and pop()
+/// by the consumer thread. Both are wait-free.
+///
+////////////////////////////////////////////////////////////
+template <typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an item at the end of the ring
+    ///
+    /// \param item  Item to add
+    ///
+    /// \return True if the item has been added, false if the ring is full
+    ///
+    ////////////////////////////////////////////////////////////
+    bool push(const T& item)
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        _items[head & (Capacity - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove the item at the start of the ring
+    ///
+    /// \param item  Receives the removed item
+    ///
+    /// \return True if an item has been removed, false if the ring is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    bool pop(T& item)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire))
+            return false;
+
+        item = _items[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Each index lives on its own cache line, only its owner writes it
+    alignas(64) std::atomic<std::size_t> _head{0};  //!< Index of the next pushed item, written by the producer
+    alignas(64) std::atomic<std::size_t> _tail{0};  //!< Index of the next popped item, written by the consumer
+    alignas(64) T _items[Capacity];                 //!< Storage of the items
+};
+
+}
+}
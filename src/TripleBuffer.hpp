@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <atomic>
+
+namespace sf
+{
+namespace priv
+{
+
+////////////////////////////////////////////////////////////
+/// \brief Publishes values from one writer thread to any number of reader threads
+///
+/// The writer fills a buffer that no reader uses, then makes it
+/// the latest one with a single atomic store. Readers pin the
+/// latest buffer while they copy it, so they always read a
+/// complete value and never block on a write in progress.
+///
+/// This is lock-free, not wait-free : a reader pins again when a
+/// value is published between its load and its pin, and the writer
+/// gives up when readers pin the two buffers that are not the
+/// latest one. Three buffers cannot do better for several readers
+/// of a value that is not trivially copyable.
+///
+/// publish() must only be called by one thread at a time.
+///
+////////////////////////////////////////////////////////////
+template <typename T>
+class TripleBuffer
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Write a new value and make it the latest one
+    ///
+    /// \param writer  Function that fills the buffer, called with a T&
+    ///
+    /// The writer is not called when readers pin the two other
+    /// buffers : the latest value stays the previous one.
+    ///
+    /// \return True if the value has been published, false if all the buffers are in use
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename Writer>
+    bool publish(Writer&& writer)
+    {
+        // A buffer that is neither the latest nor pinned : readers arriving
+        // from now on only pin the latest one, or give up on a stale one
+        const int latest = _latest.load();
+        int index = 0;
+        while (index < BufferCount && (index == latest || _pins[index].load() != 0))
+            index++;
+
+        if (index == BufferCount)
+            return false;
+
+        writer(_buffers[index]);
+        _latest.store(index);
+        return true;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the latest value
+    ///
+    /// \param reader  Function that reads the buffer, called with a const T&
+    ///
+    /// \return True if a value has been read, false if nothing has been published yet
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename Reader>
+    bool read(Reader&& reader) const
+    {
+        int index = _latest.load();
+        if (index < 0)
+            return false;
+
+        // The pin only protects the buffer if it is still the latest one once
+        // pinned : otherwise the writer may have chosen it before the pin
+        _pins[index].fetch_add(1);
+        while (_latest.load() != index)
+        {
+            _pins[index].fetch_sub(1);
+            index = _latest.load();
+            _pins[index].fetch_add(1);
+        }
+
+        reader(static_cast<const T&>(_buffers[index]));
+        _pins[index].fetch_sub(1);
+        return true;
+    }
+
+private:
+    static constexpr int BufferCount = 3; //!< Latest value, value being written, value being read
+
+    T                        _buffers[BufferCount];   //!< Published values
+    std::atomic<int>         _latest{-1};             //!< Index of the latest value, -1 before the first one
+    mutable std::atomic<int> _pins[BufferCount]{};    //!< Number of readers of each buffer
+};
+
+}
+}
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/VirtualGamepadBackend.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+VirtualGamepadBackend::VirtualGamepadBackend(unsigned int count) :
+_devices(count)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void VirtualGamepadBackend::setCount(unsigned int count)
+{
+    _devices.resize(count);
+}
+
+
+////////////////////////////////////////////////////////////
+void VirtualGamepadBackend::connect(unsigned int joystick, unsigned int vendorId, unsigned int productId,
+    const String& name)
+{
+    if (joystick >= _devices.size())
+        return;
+
+    // A new connection number tells the slot cache that another joystick may be in the slot
+    auto& device = _devices[joystick];
+    device = Device();
+    device.connected = true;
+    device.connection = ++_connections;
+    device.identification.vendorId = vendorId;
+    device.identification.productId = productId;
+    device.identification.name = name;
+}
+
+
+////////////////////////////////////////////////////////////
+void VirtualGamepadBackend::disconnect(unsigned int joystick)
+{
+    if (joystick >= _devices.size())
+        return;
+
+    auto& device = _devices[joystick];
+    device = Device();
+    device.connection = ++_connections;
+}
+
+
+////////////////////////////////////////////////////////////
+void VirtualGamepadBackend::setButton(unsigned int joystick, unsigned int button, bool pressed)
+{
+    if (joystick >= _devices.size() || button >= Joystick::ButtonCount)
+        return;
+
+    auto& buttons = _devices[joystick].buttons;
+    if (pressed)
+        buttons |= 1u << button;
+    else
+        buttons &= ~(1u << button);
+}
+
+
+////////////////////////////////////////////////////////////
+void VirtualGamepadBackend::setAxis(unsigned int joystick, Joystick::Axis axis, float position)
+{
+    if (joystick >= _devices.size() || static_cast<unsigned int>(axis) >= Joystick::AxisCount)
+        return;
+
+    _devices[joystick].axes[axis] = position < -100.f ? -100.f : (position > 100.f ? 100.f : position);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VirtualGamepadBackend::getCount()
+{
+    return static_cast<unsigned int>(_devices.size());
+}
+
+
+////////////////////////////////////////////////////////////
+bool VirtualGamepadBackend::update()
+{
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VirtualGamepadBackend::isConnected(unsigned int joystick)
+{
+    return joystick < _devices.size() && _devices[joystick].connected;
+}
+
+
+////////////////////////////////////////////////////////////
+Joystick::Identification VirtualGamepadBackend::getIdentification(unsigned int joystick)
+{
+    return joystick < _devices.size() ? _devices[joystick].identification : Joystick::Identification();
+}
+
+
+////////////////////////////////////////////////////////////
+bool VirtualGamepadBackend::isButtonPressed(unsigned int joystick, unsigned int button)
+{
+    return joystick < _devices.size() && button < Joystick::ButtonCount && ((_devices[joystick].buttons >> button) & 1u);
+}
+
+
+////////////////////////////////////////////////////////////
+float VirtualGamepadBackend::getAxisPosition(unsigned int joystick, Joystick::Axis axis)
+{
+    return joystick < _devices.size() ? _devices[joystick].axes[axis] : 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VirtualGamepadBackend::getConnection(unsigned int joystick, unsigned int& connection)
+{
+    if (!isConnected(joystick))
+        return false;
+
+    connection = _devices[joystick].connection;
+    return true;
+}
+
+}
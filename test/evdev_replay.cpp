@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Check of the evdev backend : replays a recorded event stream
+// through a pipe, cut in records of odd sizes, and compares the
+// gamepad states with the recorded ones
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFMLGamepad/EvdevGamepadBackend.hpp>
+#include <SFMLGamepad/Gamepad.hpp>
+
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+using Control = sf::Gamepad::Control;
+
+////////////////////////////////////////////////////////////
+/// Append an event to a recorded stream
+////////////////////////////////////////////////////////////
+void record(std::vector<input_event>& stream, unsigned short type, unsigned short code, int value)
+{
+    input_event event{};
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    stream.push_back(event);
+}
+
+////////////////////////////////////////////////////////////
+/// Report a failed check
+////////////////////////////////////////////////////////////
+bool check(bool condition, const char* description)
+{
+    if (!condition)
+        std::cerr << "Failed: " << description << std::endl;
+
+    return condition;
+}
+
+}
+
+
+////////////////////////////////////////////////////////////
+int main()
+{
+    sf::Gamepad::loadMappingFromString(
+        "03000000341200007856000000000000,Recorded pad,a:b0,b:b1,leftx:a0,lefty:a1,platform:Linux,\n");
+
+    sf::EvdevGamepadBackend::DeviceInfo info;
+    info.identification.name = "Recorded pad";
+    info.identification.vendorId = 0x1234;
+    info.identification.productId = 0x5678;
+    info.buttons = {BTN_SOUTH, BTN_EAST};
+    info.axes = {{ABS_X, -32768, 32767}, {ABS_Y, -32768, 32767}};
+
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        std::cerr << "Could not create a pipe" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    sf::EvdevGamepadBackend backend;
+    if (!backend.attach(fds[0], info))
+        return EXIT_FAILURE;
+
+    sf::Gamepad::setBackend(&backend);
+
+    // A and B pressed, the left stick pushed right, then A released
+    std::vector<input_event> stream;
+    record(stream, EV_KEY, BTN_SOUTH, 1);
+    record(stream, EV_KEY, BTN_EAST, 1);
+    record(stream, EV_ABS, ABS_X, 32767);
+    record(stream, EV_SYN, SYN_REPORT, 0);
+    record(stream, EV_KEY, BTN_SOUTH, 0);
+    record(stream, EV_SYN, SYN_REPORT, 0);
+
+    // The stream is written in pieces that cut the records, each one read before the next
+    const auto* bytes = reinterpret_cast<const char*>(stream.data());
+    const std::size_t size = stream.size() * sizeof(input_event);
+    constexpr std::size_t pieceSize = 7;
+
+    bool passed = true;
+    bool sawBoth = false;
+    for (std::size_t offset = 0; offset < size; offset += pieceSize)
+    {
+        const auto length = std::min(pieceSize, size - offset);
+        if (write(fds[1], bytes + offset, length) != static_cast<ssize_t>(length))
+        {
+            std::cerr << "Could not write the stream" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        sf::Gamepad::update();
+        sawBoth = sawBoth || (sf::Gamepad::isPressed(0, Control::A) && sf::Gamepad::isPressed(0, Control::B));
+    }
+
+    passed &= check(sf::Gamepad::isAvailable(0), "the replayed pad is available");
+    passed &= check(sawBoth, "A and B are pressed together");
+    passed &= check(!sf::Gamepad::isPressed(0, Control::A), "A is released at the end");
+    passed &= check(sf::Gamepad::isPressed(0, Control::B), "B is still pressed at the end");
+    passed &= check(std::abs(sf::Gamepad::getPosition(0, Control::LeftXPlus) - 100.f) < 0.5f, "the left stick is pushed right");
+
+    // The device is disconnected at the end of the stream
+    close(fds[1]);
+    sf::Gamepad::update();
+    passed &= check(!sf::Gamepad::isAvailable(0), "the pad is disconnected at the end of the stream");
+
+    sf::Gamepad::setBackend(nullptr);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
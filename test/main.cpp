@@ -179,12 +179,14 @@ int main()
             connectionStatus.setString("Gamepad " + std::to_string(gamepad) + " unavailable");
         }
 
+        auto gamepadState = sf::Gamepad::capture(gamepad);
+
         window.clear();
         for (auto& ci : controlInfos)
         {
             state.setValue(ci.name,
-                           sf::Gamepad::getPosition(gamepad, ci.control),
-                           sf::Gamepad::isPressed(gamepad, ci.control));
+                           gamepadState.getPosition(ci.control),
+                           gamepadState.isPressed(ci.control));
             state.setPosition(ci.position);
             window.draw(state);
         }
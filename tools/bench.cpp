@@ -0,0 +1,361 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Microbenchmarks of the mapping hot paths : database parsing,
+// control lookups and the per-call queries, on virtual gamepads.
+// Prints the results as JSON, to be tracked over time.
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <GamepadImpl.hpp>
+#include <SFMLGamepad/VirtualGamepadBackend.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef SFML_GAMEPAD_BENCH_DATABASE
+    #define SFML_GAMEPAD_BENCH_DATABASE "gamecontrollerdb.txt"
+#endif
+
+namespace
+{
+using impl = sf::priv::GamepadImpl;
+using Clock = std::chrono::steady_clock;
+using Control = sf::Gamepad::Control;
+
+////////////////////////////////////////////////////////////
+/// Result of a benchmark, in nanoseconds per operation
+////////////////////////////////////////////////////////////
+struct Result
+{
+    std::string name;
+    std::size_t operations;     // Operations per sample
+    double      median;
+    double      minimum;
+};
+
+////////////////////////////////////////////////////////////
+/// Keeps the results of the queries alive
+////////////////////////////////////////////////////////////
+volatile float sink;
+
+constexpr auto MinSampleTime = std::chrono::milliseconds(20);
+
+////////////////////////////////////////////////////////////
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--samples <count>] [--gamepads <count>] [database.txt]" << std::endl
+              << "  --samples   Number of samples of each benchmark. Defaults to 5." << std::endl
+              << "  --gamepads  Number of virtual gamepads. Defaults to 16." << std::endl
+              << "  database    Text database to load. Defaults to the one of the SDL_GameControllerDB submodule." << std::endl;
+}
+
+////////////////////////////////////////////////////////////
+/// Time count operations of a benchmark body
+////////////////////////////////////////////////////////////
+template <typename Body>
+double time(Body& body, std::size_t count)
+{
+    const auto start = Clock::now();
+    body(count);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+////////////////////////////////////////////////////////////
+/// Run a benchmark : the number of operations per sample is
+/// doubled until a sample lasts long enough to be measured
+////////////////////////////////////////////////////////////
+template <typename Body>
+Result run(const std::string& name, unsigned int samples, Body&& body)
+{
+    std::size_t count = 1;
+    while (time(body, count) < std::chrono::duration<double, std::nano>(MinSampleTime).count() && count < (1u << 30))
+        count *= 2;
+
+    std::vector<double> times;
+    for (unsigned int i = 0; i < samples; i++)
+        times.push_back(time(body, count) / static_cast<double>(count));
+
+    std::sort(times.begin(), times.end());
+    std::cerr << name << ": " << times[times.size() / 2] << " ns" << std::endl;
+    return {name, count, times[times.size() / 2], times.front()};
+}
+
+////////////////////////////////////////////////////////////
+/// Connect virtual gamepads with the IDs of the database lines
+/// that have a mapping on the current platform
+////////////////////////////////////////////////////////////
+unsigned int connectGamepads(sf::VirtualGamepadBackend& backend, const std::string& text, unsigned int count)
+{
+    std::istringstream lines(text);
+    std::string line;
+    unsigned int connected = 0;
+
+    while (connected < count && std::getline(lines, line))
+    {
+        if (line.size() < 32 || line[0] == '#')
+            continue;
+
+        // Same layout as GamepadImpl::parseGUID(), little-endian IDs
+        const auto id = [&line](std::size_t offset) {
+            return static_cast<unsigned int>(std::strtoul(line.substr(offset + 2, 2).c_str(), nullptr, 16) << 8 |
+                                             std::strtoul(line.substr(offset, 2).c_str(), nullptr, 16));
+        };
+
+        // The slot is reused until a line resolves : drop the resolution of the previous miss
+        backend.connect(connected, id(8), id(16));
+        impl::invalidateSlots();
+        if (impl::isAvailable(connected))
+            connected++;
+    }
+
+    // Some presses and tilts, so that the queries do the whole work
+    for (unsigned int gamepad = 0; gamepad < connected; gamepad++)
+    {
+        backend.setButton(gamepad, gamepad % 4, true);
+        backend.setAxis(gamepad, sf::Joystick::X, 75.f);
+        backend.setAxis(gamepad, sf::Joystick::Y, -30.f);
+    }
+
+    return connected;
+}
+
+////////////////////////////////////////////////////////////
+void printResults(const std::string& database, unsigned int gamepads, const std::vector<Result>& results)
+{
+    // Database paths are printed as is, only quotes and backslashes are escaped
+    std::string escaped;
+    for (char c : database)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "{" << std::endl
+              << "  \"database\": \"" << escaped << "\"," << std::endl
+              << "  \"mappings\": " << impl::getEntryCount() << "," << std::endl
+              << "  \"gamepads\": " << gamepads << "," << std::endl
+              << "  \"unit\": \"ns/op\"," << std::endl
+              << "  \"results\": [" << std::endl;
+
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const auto& result = results[i];
+        std::cout << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+                  << ", \"median\": " << result.median << ", \"min\": " << result.minimum << "}"
+                  << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    std::cout << "  ]" << std::endl
+              << "}" << std::endl;
+}
+
+}
+
+
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    std::string database = SFML_GAMEPAD_BENCH_DATABASE;
+    unsigned int samples = 5;
+    unsigned int gamepadCount = 16;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc)
+        {
+            samples = std::max(static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+        }
+        else if (arg == "--gamepads" && i + 1 < argc)
+        {
+            gamepadCount = std::max(static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+        }
+        else if (arg[0] != '-')
+        {
+            database = arg;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ifstream file(database, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not load '" << database << "'" << std::endl;
+        if (database == SFML_GAMEPAD_BENCH_DATABASE)
+            std::cerr << "The default database comes from the SDL_GameControllerDB submodule, check it out "
+                      << "or give another database as last argument" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ostringstream content;
+    content << file.rdbuf();
+    const auto text = content.str();
+
+    std::vector<Result> results;
+
+    ////////////////////////////////////////////////////////////
+    // Parsing : loading the same database again replaces its
+    // entries, their number does not grow
+    ////////////////////////////////////////////////////////////
+    impl::setLazyLoading(true);
+    results.push_back(run("loadMappingFromString/lazy", samples, [&text](std::size_t count) {
+        for (std::size_t i = 0; i < count; i++)
+            impl::loadMappingFromString(text);
+    }));
+
+    impl::setLazyLoading(false);
+    results.push_back(run("loadMappingFromString", samples, [&text](std::size_t count) {
+        for (std::size_t i = 0; i < count; i++)
+            impl::loadMappingFromString(text);
+    }));
+
+    // One more slot for an unknown gamepad
+    sf::VirtualGamepadBackend backend(gamepadCount + 1);
+    sf::Gamepad::setBackend(&backend);
+
+    const auto gamepads = connectGamepads(backend, text, gamepadCount);
+    if (gamepads < gamepadCount)
+    {
+        std::cerr << "'" << database << "' has " << gamepads << " mappings for this platform, " << gamepadCount
+                  << " needed (use --gamepads to lower the count)" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto unknown = gamepads;
+    backend.connect(unknown, 0xFFFF, 0xFFFF);
+
+    ////////////////////////////////////////////////////////////
+    // Lookups
+    ////////////////////////////////////////////////////////////
+    results.push_back(run("getControlInfo/hit", samples, [gamepads](std::size_t count) {
+        unsigned int ids = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const auto control = static_cast<Control>(1 + i % (sf::Gamepad::ControlCount - 1));
+            ids += impl::getControlInfo(control, static_cast<unsigned int>(i % gamepads)).id;
+        }
+        sink = static_cast<float>(ids);
+    }));
+
+    results.push_back(run("getControlInfo/miss", samples, [unknown](std::size_t count) {
+        unsigned int ids = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const auto control = static_cast<Control>(1 + i % (sf::Gamepad::ControlCount - 1));
+            ids += impl::getControlInfo(control, unknown).id;
+        }
+        sink = static_cast<float>(ids);
+    }));
+
+    // Invalidating the cached resolutions measures the database probes
+    results.push_back(run("getControlInfo/resolve", samples, [gamepads](std::size_t count) {
+        unsigned int ids = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            impl::invalidateSlots();
+            ids += impl::getControlInfo(Control::A, static_cast<unsigned int>(i % gamepads)).id;
+        }
+        sink = static_cast<float>(ids);
+    }));
+
+    ////////////////////////////////////////////////////////////
+    // Queries, per call
+    ////////////////////////////////////////////////////////////
+    const auto query = [gamepads, samples, &results](const std::string& name, auto&& call) {
+        results.push_back(run(name, samples, [gamepads, &call](std::size_t count) {
+            float total = 0.f;
+            for (std::size_t i = 0; i < count; i++)
+            {
+                const auto control = static_cast<Control>(1 + i % (sf::Gamepad::ControlCount - 1));
+                total += call(static_cast<unsigned int>(i % gamepads), control);
+            }
+            sink = total;
+        }));
+    };
+
+    query("getPosition", [](unsigned int gamepad, Control control) {
+        return sf::Gamepad::getPosition(gamepad, control);
+    });
+    query("isPressed", [](unsigned int gamepad, Control control) {
+        return sf::Gamepad::isPressed(gamepad, control) ? 1.f : 0.f;
+    });
+    query("hasControl", [](unsigned int gamepad, Control control) {
+        return sf::Gamepad::hasControl(gamepad, control) ? 1.f : 0.f;
+    });
+
+    ////////////////////////////////////////////////////////////
+    // Frames : every control of every gamepad
+    ////////////////////////////////////////////////////////////
+    results.push_back(run("frame/calls", samples, [gamepads](std::size_t count) {
+        float total = 0.f;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            sf::Gamepad::update();
+            for (unsigned int gamepad = 0; gamepad < gamepads; gamepad++)
+            {
+                for (unsigned int c = 1; c < sf::Gamepad::ControlCount; c++)
+                {
+                    const auto control = static_cast<Control>(c);
+                    total += sf::Gamepad::getPosition(gamepad, control) + (sf::Gamepad::isPressed(gamepad, control) ? 1.f : 0.f);
+                }
+            }
+        }
+        sink = total;
+    }));
+
+    std::vector<sf::Gamepad::State> states;
+    results.push_back(run("frame/captureAll", samples, [&states](std::size_t count) {
+        std::uint32_t pressed = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            sf::Gamepad::update();
+            sf::Gamepad::captureAll(states);
+            for (const auto& state : states)
+                pressed ^= state.pressed;
+        }
+        sink = static_cast<float>(pressed);
+    }));
+
+    sf::Gamepad::setBackend(nullptr);
+
+    printResults(database, gamepads, results);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////
+//
+// SFMLGamepad - Gamepad mapping for SFML
+// Copyright (C) 2022 Pierre-Alexandre Pousset <pea.pousset@gmail.com>
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Mapping database compiler : converts a text database to
+// the compiled format loaded by Gamepad::loadMappingFromBinary,
+// or to a table for Gamepad::setMappingTable
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <GamepadImpl.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+using impl = sf::priv::GamepadImpl;
+
+////////////////////////////////////////////////////////////
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--platform <name>] [--header <symbol>] <input.txt> <output>" << std::endl
+              << "  --platform  Platform of the mappings to compile: Linux, Windows, \"Mac OS X\"," << std::endl
+              << "              Android or iOS. Defaults to the current platform." << std::endl
+              << "  --header    Write a C++ header that defines the mapping table <symbol>," << std::endl
+              << "              instead of a compiled database." << std::endl;
+}
+
+}
+
+
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+    std::string symbol;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--platform" && i + 1 < argc)
+        {
+            impl::Platform platform;
+            if (!impl::parsePlatform(argv[++i], platform))
+            {
+                std::cerr << "Unknown platform '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+            impl::setPlatform(platform);
+        }
+        else if (arg == "--header" && i + 1 < argc)
+        {
+            symbol = argv[++i];
+        }
+        else if (input.empty())
+        {
+            input = arg;
+        }
+        else if (output.empty())
+        {
+            output = arg;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (input.empty() || output.empty())
+    {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!impl::loadMappingFromFile(input))
+        return EXIT_FAILURE;
+
+    const bool saved = symbol.empty() ? impl::saveMappingToBinary(output)
+                                      : impl::saveMappingToHeader(output, symbol);
+    if (!saved)
+        return EXIT_FAILURE;
+
+    std::cout << "Compiled " << impl::getEntryCount() << " mappings to '" << output << "'" << std::endl;
+    return EXIT_SUCCESS;
+}